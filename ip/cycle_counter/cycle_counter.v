@@ -0,0 +1,44 @@
+//=======================================================
+//  cycle_counter: free-running 64-bit clock cycle
+//  counter, read with single loads
+//
+//  Registers (32-bit, word offsets, read only):
+//    0 COUNT     [31:0]  of the count
+//    1 COUNT_HI  [63:32] of the count
+//
+//  The count starts at 0 after reset and goes up by
+//  one every clock. A 32-bit time is one load of COUNT;
+//  a 64-bit time reads COUNT_HI, COUNT, COUNT_HI again
+//  and retries if COUNT_HI changed in between. Reads
+//  have no side effects, so interrupts need no care.
+//  There is no write side.
+//=======================================================
+
+module cycle_counter (
+	input              clk,
+	input              reset_n,
+
+	input              address,
+	input              chipselect,
+	output reg [31:0]  readdata
+);
+
+//=======================================================
+//  REG/WIRE declarations
+//=======================================================
+reg  [63:0] count;
+
+//=======================================================
+//  Counter
+//=======================================================
+always @(posedge clk or negedge reset_n)
+	if (!reset_n) count <= 64'd0;
+	else          count <= count + 64'd1;
+
+//=======================================================
+//  Avalon-MM slave, read side
+//=======================================================
+always @(*)
+	readdata = address ? count[63:32] : count[31:0];
+
+endmodule
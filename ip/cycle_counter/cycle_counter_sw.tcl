@@ -0,0 +1,16 @@
+#
+# cycle_counter_sw.tcl
+#
+# Register header only, no HAL device driver
+
+create_driver cycle_counter_driver
+
+set_sw_property hw_class_name cycle_counter
+set_sw_property version 1.0
+set_sw_property min_compatible_hw_version 1.0
+set_sw_property auto_initialize false
+set_sw_property bsp_subdirectory drivers
+
+add_sw_property include_source inc/cycle_counter_regs.h
+
+add_sw_property supported_bsp_type HAL
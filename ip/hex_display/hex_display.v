@@ -0,0 +1,109 @@
+//=======================================================
+//  hex_display: Avalon-MM driver for the six seven-
+//  segment displays HEX0..HEX5
+//
+//  Registers (32-bit, word offsets):
+//    0 DIGITS    [23:0] one hex digit per display, HEX0
+//                in [3:0]. 0..9 from BCD, A..F as
+//                letters (b and d lower case)
+//    1 SEG_LO    raw segments HEX0..HEX3, one byte each
+//                (HEX0 in [6:0]), bit 0 = a .. bit 6 = g,
+//                1 = lit
+//    2 SEG_HI    raw segments HEX4 [6:0], HEX5 [14:8]
+//    3 CONTROL   [5:0]  RAW: display n shows its SEG
+//                       byte instead of its digit
+//                [13:8] BLANK: display n is dark
+//
+//  After reset every display is blank. The outputs are
+//  registered and active low, as the DE10 wires them.
+//=======================================================
+
+module hex_display (
+	input              clk,
+	input              reset_n,
+
+	input       [1:0]  address,
+	input              chipselect,
+	input              write_n,
+	input      [31:0]  writedata,
+	output reg [31:0]  readdata,
+
+	output reg [41:0]  hex_out				// {HEX5, HEX4, .., HEX0}
+);
+
+//=======================================================
+//  REG/WIRE declarations
+//=======================================================
+reg  [23:0] digits;
+reg  [31:0] seg_lo;
+reg  [15:0] seg_hi;
+reg   [5:0] raw, blank;
+
+wire        wr = chipselect & ~write_n;
+wire [47:0] seg_all = {seg_hi, seg_lo};		// byte n = display n
+
+integer n;
+
+//=======================================================
+//  Hex digit to segments (1 = lit)
+//=======================================================
+function [6:0] decode(input [3:0] d);
+	case (d)
+		4'h0: decode = 7'b0111111;
+		4'h1: decode = 7'b0000110;
+		4'h2: decode = 7'b1011011;
+		4'h3: decode = 7'b1001111;
+		4'h4: decode = 7'b1100110;
+		4'h5: decode = 7'b1101101;
+		4'h6: decode = 7'b1111101;
+		4'h7: decode = 7'b0000111;
+		4'h8: decode = 7'b1111111;
+		4'h9: decode = 7'b1101111;
+		4'hA: decode = 7'b1110111;
+		4'hB: decode = 7'b1111100;
+		4'hC: decode = 7'b0111001;
+		4'hD: decode = 7'b1011110;
+		4'hE: decode = 7'b1111001;
+		default: decode = 7'b1110001;
+	endcase
+endfunction
+
+//=======================================================
+//  Avalon-MM slave
+//=======================================================
+always @(posedge clk or negedge reset_n)
+	if (!reset_n) begin
+		digits <= 24'd0;
+		seg_lo <= 32'd0;
+		seg_hi <= 16'd0;
+		raw    <= 6'd0;
+		blank  <= 6'h3F;
+	end else if (wr) begin
+		case (address)
+			2'd0: digits <= writedata[23:0];
+			2'd1: seg_lo <= writedata;
+			2'd2: seg_hi <= writedata[15:0];
+			2'd3: {blank, raw} <= {writedata[13:8], writedata[5:0]};
+		endcase
+	end
+
+always @(*)
+	case (address)
+		2'd0:    readdata = {8'd0, digits};
+		2'd1:    readdata = seg_lo;
+		2'd2:    readdata = {16'd0, seg_hi};
+		default: readdata = {18'd0, blank, 2'd0, raw};
+	endcase
+
+//=======================================================
+//  Output: all six displays change on the same clock
+//=======================================================
+always @(posedge clk or negedge reset_n)
+	if (!reset_n)
+		hex_out <= {42{1'b1}};
+	else
+		for (n = 0; n < 6; n = n + 1)
+			hex_out[7*n +: 7] <= blank[n] ? 7'h7F :
+			                     raw[n]   ? ~seg_all[8*n +: 7] : ~decode(digits[4*n +: 4]);
+
+endmodule
@@ -0,0 +1,79 @@
+# hex_display "HEX Display" v1.0
+# Avalon-MM driver for the seven-segment displays HEX0..HEX5
+
+package require -exact qsys 16.1
+
+#
+# module hex_display
+#
+set_module_property DESCRIPTION "Six seven-segment displays from hex digits or raw segment patterns, with a blank mask"
+set_module_property NAME hex_display
+set_module_property VERSION 1.0
+set_module_property INTERNAL false
+set_module_property OPAQUE_ADDRESS_MAP true
+set_module_property GROUP "miniProject"
+set_module_property AUTHOR ""
+set_module_property DISPLAY_NAME "HEX Display"
+set_module_property INSTANTIATE_IN_SYSTEM_MODULE true
+set_module_property EDITABLE false
+set_module_property REPORT_TO_TALKBACK false
+set_module_property ALLOW_GREYBOX_GENERATION false
+set_module_property REPORT_HIERARCHY false
+
+#
+# file sets
+#
+add_fileset QUARTUS_SYNTH QUARTUS_SYNTH "" ""
+set_fileset_property QUARTUS_SYNTH TOP_LEVEL hex_display
+add_fileset_file hex_display.v VERILOG PATH hex_display.v TOP_LEVEL_FILE
+
+add_fileset SIM_VERILOG SIM_VERILOG "" ""
+set_fileset_property SIM_VERILOG TOP_LEVEL hex_display
+add_fileset_file hex_display.v VERILOG PATH hex_display.v
+
+#
+# connection point clock
+#
+add_interface clock clock end
+set_interface_property clock clockRate 0
+add_interface_port clock clk clk Input 1
+
+#
+# connection point reset
+#
+add_interface reset reset end
+set_interface_property reset associatedClock clock
+set_interface_property reset synchronousEdges DEASSERT
+add_interface_port reset reset_n reset_n Input 1
+
+#
+# connection point s1
+#
+add_interface s1 avalon end
+set_interface_property s1 addressUnits WORDS
+set_interface_property s1 associatedClock clock
+set_interface_property s1 associatedReset reset
+set_interface_property s1 explicitAddressSpan 0
+set_interface_property s1 maximumPendingReadTransactions 0
+set_interface_property s1 readLatency 0
+set_interface_property s1 readWaitTime 0
+set_interface_property s1 writeWaitTime 0
+set_interface_property s1 timingUnits Cycles
+set_interface_property s1 ENABLED true
+add_interface_port s1 address address Input 2
+add_interface_port s1 chipselect chipselect Input 1
+add_interface_port s1 write_n write_n Input 1
+add_interface_port s1 writedata writedata Input 32
+add_interface_port s1 readdata readdata Output 32
+set_interface_assignment s1 embeddedsw.configuration.isFlash 0
+set_interface_assignment s1 embeddedsw.configuration.isMemoryDevice 0
+set_interface_assignment s1 embeddedsw.configuration.isNonVolatileStorage 0
+set_interface_assignment s1 embeddedsw.configuration.isPrintableDevice 0
+
+#
+# connection point external_connection
+#
+add_interface external_connection conduit end
+set_interface_property external_connection associatedClock clock
+set_interface_property external_connection associatedReset reset
+add_interface_port external_connection hex_out export Output 42
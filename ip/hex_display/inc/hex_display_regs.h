@@ -0,0 +1,43 @@
+#ifndef __HEX_DISPLAY_REGS_H__
+#define __HEX_DISPLAY_REGS_H__
+
+#include <io.h>
+
+/*
+ * hex_display register map (ip/hex_display/hex_display.v)
+ *
+ * DIGITS holds one hex digit per display (HEX0 in the low nibble), SEG_LO
+ * and SEG_HI one raw segment byte per display (HEX0 in the low byte of
+ * SEG_LO, HEX4 and HEX5 in SEG_HI), bit 0 = segment a .. bit 6 = g, 1 = lit.
+ * CONTROL RAW selects the segment byte instead of the digit for a display,
+ * CONTROL BLANK turns a display off. All displays are blank after reset.
+ */
+
+#define IOADDR_HEX_DISPLAY_DIGITS(base)         __IO_CALC_ADDRESS_NATIVE(base, 0)
+#define IORD_HEX_DISPLAY_DIGITS(base)           IORD(base, 0)
+#define IOWR_HEX_DISPLAY_DIGITS(base, data)     IOWR(base, 0, data)
+
+#define HEX_DISPLAY_DIGITS_MSK                  (0xFFFFFF)
+#define HEX_DISPLAY_DIGIT_OFST(n)               (4 * (n))
+
+#define IOADDR_HEX_DISPLAY_SEG_LO(base)         __IO_CALC_ADDRESS_NATIVE(base, 1)
+#define IORD_HEX_DISPLAY_SEG_LO(base)           IORD(base, 1)
+#define IOWR_HEX_DISPLAY_SEG_LO(base, data)     IOWR(base, 1, data)
+
+#define IOADDR_HEX_DISPLAY_SEG_HI(base)         __IO_CALC_ADDRESS_NATIVE(base, 2)
+#define IORD_HEX_DISPLAY_SEG_HI(base)           IORD(base, 2)
+#define IOWR_HEX_DISPLAY_SEG_HI(base, data)     IOWR(base, 2, data)
+
+#define HEX_DISPLAY_SEG_MSK                     (0x7F)
+#define HEX_DISPLAY_SEG_OFST(n)                 (8 * ((n) & 3))     /* in SEG_LO for 0..3, SEG_HI for 4..5 */
+
+#define IOADDR_HEX_DISPLAY_CONTROL(base)        __IO_CALC_ADDRESS_NATIVE(base, 3)
+#define IORD_HEX_DISPLAY_CONTROL(base)          IORD(base, 3)
+#define IOWR_HEX_DISPLAY_CONTROL(base, data)    IOWR(base, 3, data)
+
+#define HEX_DISPLAY_CONTROL_RAW_MSK             (0x3F)
+#define HEX_DISPLAY_CONTROL_RAW_OFST            (0)
+#define HEX_DISPLAY_CONTROL_BLANK_MSK           (0x3F00)
+#define HEX_DISPLAY_CONTROL_BLANK_OFST          (8)
+
+#endif /* __HEX_DISPLAY_REGS_H__ */
@@ -0,0 +1,48 @@
+#ifndef __LCD_REFRESH_REGS_H__
+#define __LCD_REFRESH_REGS_H__
+
+#include <io.h>
+
+/*
+ * lcd_refresh register map (ip/lcd_refresh/lcd_refresh.v)
+ *
+ * TEXT holds the 32 cells of the 2x16 panel, four per word with the
+ * leftmost cell in the low byte (words 0..3 row 0, 4..7 row 1). CGRAM holds
+ * the 8 glyphs of 8 rows, four rows per word with the top row in the low
+ * byte, 5 pixels per row (bit 4 = left). The core sends every cell and glyph
+ * whose value changed to the panel by itself. CONTROL RUN initialises the
+ * panel and starts the refresh, STATUS BUSY is set while anything is still to
+ * be sent, STATUS READY once the initialisation is done.
+ */
+
+#define LCD_REFRESH_TEXT_REG                    (0)     /* 8 words */
+#define LCD_REFRESH_TEXT_WORDS                  (8)
+#define LCD_REFRESH_CGRAM_REG                   (8)     /* 16 words */
+#define LCD_REFRESH_CGRAM_WORDS                 (16)
+
+#define IOADDR_LCD_REFRESH_TEXT(base, n)        __IO_CALC_ADDRESS_NATIVE(base, LCD_REFRESH_TEXT_REG + (n))
+#define IORD_LCD_REFRESH_TEXT(base, n)          IORD(base, LCD_REFRESH_TEXT_REG + (n))
+#define IOWR_LCD_REFRESH_TEXT(base, n, data)    IOWR(base, LCD_REFRESH_TEXT_REG + (n), data)
+
+#define IOADDR_LCD_REFRESH_CGRAM(base, n)       __IO_CALC_ADDRESS_NATIVE(base, LCD_REFRESH_CGRAM_REG + (n))
+#define IORD_LCD_REFRESH_CGRAM(base, n)         IORD(base, LCD_REFRESH_CGRAM_REG + (n))
+#define IOWR_LCD_REFRESH_CGRAM(base, n, data)   IOWR(base, LCD_REFRESH_CGRAM_REG + (n), data)
+
+#define LCD_REFRESH_CGRAM_ROW_MSK               (0x1F)
+
+#define IOADDR_LCD_REFRESH_CONTROL(base)        __IO_CALC_ADDRESS_NATIVE(base, 24)
+#define IORD_LCD_REFRESH_CONTROL(base)          IORD(base, 24)
+#define IOWR_LCD_REFRESH_CONTROL(base, data)    IOWR(base, 24, data)
+
+#define LCD_REFRESH_CONTROL_RUN_MSK             (0x1)
+#define LCD_REFRESH_CONTROL_RUN_OFST            (0)
+
+#define IOADDR_LCD_REFRESH_STATUS(base)         __IO_CALC_ADDRESS_NATIVE(base, 25)
+#define IORD_LCD_REFRESH_STATUS(base)           IORD(base, 25)
+
+#define LCD_REFRESH_STATUS_BUSY_MSK             (0x1)
+#define LCD_REFRESH_STATUS_BUSY_OFST            (0)
+#define LCD_REFRESH_STATUS_READY_MSK            (0x2)
+#define LCD_REFRESH_STATUS_READY_OFST           (1)
+
+#endif /* __LCD_REFRESH_REGS_H__ */
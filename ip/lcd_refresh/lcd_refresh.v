@@ -0,0 +1,254 @@
+//=======================================================
+//  lcd_refresh: Avalon-MM refresh controller for the
+//  HD44780 LCD 1602
+//
+//  Holds the 2x16 characters and the 8 CGRAM glyphs in
+//  registers and sends every cell or glyph that changed
+//  to the panel by itself, with the HD44780 timing.
+//
+//  Registers (32-bit, word offsets):
+//    0..7   TEXT     4 cells per word, cell 4n+k in bits
+//                    [8k+7:8k]; words 0..3 are row 0,
+//                    words 4..7 row 1
+//    8..23  CGRAM    glyph g in words 8+2g (rows 0..3)
+//                    and 9+2g (rows 4..7), row r of a word
+//                    in bits [8r+4:8r]
+//    24     CONTROL  bit 0: RUN. Set: initialise the panel
+//                    (after the power-on wait) and keep it
+//                    refreshed. Cleared: nothing is sent,
+//                    the next RUN initialises and sends
+//                    everything again
+//    25     STATUS   bit 0: BUSY, something is still to be
+//                    sent; bit 1: READY, initialised
+//
+//  A write marks only the cells (glyphs) whose value
+//  changed. Glyphs go first, then the cells in order;
+//  the set-DDRAM command is left out when the address
+//  counter already points at the cell. A cell written
+//  while it is being sent is sent again.
+//
+//  lcd_out has the LCD PIO bit order (RS RW E D7..D0),
+//  RW is always 0: every wait is the worst-case time.
+//=======================================================
+
+module lcd_refresh #(
+	parameter CLK_FREQ = 50000000
+) (
+	input              clk,
+	input              reset_n,
+
+	input       [4:0]  address,
+	input              chipselect,
+	input              write_n,
+	input      [31:0]  writedata,
+	output reg [31:0]  readdata,
+
+	output     [10:0]  lcd_out
+);
+
+//=======================================================
+//  HD44780 timing in clocks
+//=======================================================
+localparam integer CYC_US  = CLK_FREQ / 1000000;
+localparam integer T_AS    = (CYC_US * 60 + 999) / 1000;	// RS/data setup >= 40ns
+localparam integer T_EH    = CYC_US / 2;				// enable pulse >= 450ns
+localparam integer T_EXEC  = CYC_US * 50;				// command/data 37us, with margin
+localparam integer T_CLEAR = CYC_US * 1640;			// clear display 1.52ms, with margin
+localparam integer T_POWER = CYC_US * 40000;			// Vcc rise to the first command
+
+localparam [2:0] S_POWER = 3'd0, S_IDLE = 3'd1, S_SETUP = 3'd2, S_PULSE = 3'd3, S_WAIT = 3'd4;
+
+localparam [2:0] INIT_STEPS = 3'd4;
+
+//=======================================================
+//  REG/WIRE declarations
+//=======================================================
+reg   [7:0] text [0:31];					// written by the CPU
+reg   [4:0] cgram [0:63];
+reg  [31:0] text_dirty;						// cell not yet on the panel
+reg   [7:0] glyph_dirty;
+reg         run;
+
+reg   [2:0] state;
+reg  [31:0] timer;							// clocks left in the state
+reg   [2:0] init_step;
+reg         glyph_busy;						// uploading glyph_slot, next row glyph_row
+reg   [2:0] glyph_slot, glyph_row;
+reg   [6:0] ac;								// address counter of the panel
+reg         ac_valid;
+reg         rs, e;
+reg   [7:0] data;
+
+wire        wr = chipselect & ~write_n;
+wire  [3:0] cg_word = address[3:0] ^ 4'd8;	// address - 8 for 8..23
+wire  [4:0] cell = lowest32(text_dirty);
+wire  [6:0] cell_addr = {cell[4], 2'b00, cell[3:0]};
+wire  [2:0] slot = lowest8(glyph_dirty);
+
+wire        busy  = run && (state != S_IDLE || init_step != INIT_STEPS || glyph_busy ||
+                            glyph_dirty != 8'd0 || text_dirty != 32'd0);
+wire        ready = (init_step == INIT_STEPS);
+
+assign lcd_out = {rs, 1'b0, e, data};
+
+integer i;
+
+//=======================================================
+//  Lowest set bit: cells and glyphs go out in order
+//=======================================================
+function [4:0] lowest32(input [31:0] v);
+	integer k;
+	begin
+		lowest32 = 5'd0;
+		for (k = 31; k >= 0; k = k - 1)
+			if (v[k]) lowest32 = k[4:0];
+	end
+endfunction
+
+function [2:0] lowest8(input [7:0] v);
+	integer k;
+	begin
+		lowest8 = 3'd0;
+		for (k = 7; k >= 0; k = k - 1)
+			if (v[k]) lowest8 = k[2:0];
+	end
+endfunction
+
+function [7:0] init_cmd(input [2:0] step);
+	case (step)
+		3'd0:    init_cmd = 8'b00111000;		// 8 bit, 2 lines
+		3'd1:    init_cmd = 8'b00001100;		// display on, no cursor
+		3'd2:    init_cmd = 8'b00000110;		// entry mode: increment
+		default: init_cmd = 8'b00000001;		// clear display
+	endcase
+endfunction
+
+//=======================================================
+//  Avalon-MM slave, read side
+//=======================================================
+always @(*)
+	if (address < 5'd8)
+		readdata = {text[{address[2:0], 2'd3}], text[{address[2:0], 2'd2}],
+		            text[{address[2:0], 2'd1}], text[{address[2:0], 2'd0}]};
+	else if (address < 5'd24)
+		readdata = {3'd0, cgram[{cg_word, 2'd3}], 3'd0, cgram[{cg_word, 2'd2}],
+		            3'd0, cgram[{cg_word, 2'd1}], 3'd0, cgram[{cg_word, 2'd0}]};
+	else if (address == 5'd24)
+		readdata = {31'd0, run};
+	else
+		readdata = {30'd0, ready, busy};
+
+//=======================================================
+//  Sequencer and CPU writes. The CPU side comes last,
+//  so a cell written while it is being sent stays
+//  dirty
+//=======================================================
+always @(posedge clk or negedge reset_n)
+	if (!reset_n) begin
+		for (i = 0; i < 32; i = i + 1) text[i]  <= 8'h20;
+		for (i = 0; i < 64; i = i + 1) cgram[i] <= 5'd0;
+		text_dirty  <= 32'hFFFFFFFF;
+		glyph_dirty <= 8'hFF;
+		run         <= 1'b0;
+		state       <= S_POWER;
+		timer       <= T_POWER - 1;
+		init_step   <= 3'd0;
+		glyph_busy  <= 1'b0;
+		glyph_slot  <= 3'd0;
+		glyph_row   <= 3'd0;
+		ac          <= 7'd0;
+		ac_valid    <= 1'b0;
+		rs          <= 1'b0;
+		e           <= 1'b0;
+		data        <= 8'd0;
+	end else begin
+		case (state)
+			S_POWER:
+				if (timer == 32'd0) state <= S_IDLE;
+				else timer <= timer - 32'd1;
+
+			S_IDLE:
+				if (!run) begin
+					// stopped: initialise and send everything on the next RUN
+					init_step   <= 3'd0;
+					text_dirty  <= 32'hFFFFFFFF;
+					glyph_dirty <= 8'hFF;
+					glyph_busy  <= 1'b0;
+					ac_valid    <= 1'b0;
+				end else if (init_step != INIT_STEPS) begin
+					send(1'b0, init_cmd(init_step));
+					init_step <= init_step + 3'd1;
+				end else if (glyph_busy) begin
+					send(1'b1, {3'd0, cgram[{glyph_slot, glyph_row}]});
+					glyph_row <= glyph_row + 3'd1;
+					if (glyph_row == 3'd7) glyph_busy <= 1'b0;
+				end else if (glyph_dirty != 8'd0) begin
+					send(1'b0, {2'b01, slot, 3'b000});	// set CGRAM address
+					glyph_dirty[slot] <= 1'b0;
+					glyph_slot <= slot;
+					glyph_row  <= 3'd0;
+					glyph_busy <= 1'b1;
+					ac_valid   <= 1'b0;
+				end else if (text_dirty != 32'd0) begin
+					if (ac_valid && ac == cell_addr) begin
+						send(1'b1, text[cell]);
+						text_dirty[cell] <= 1'b0;
+						ac <= ac + 7'd1;
+					end else begin
+						send(1'b0, {1'b1, cell_addr});	// set DDRAM address
+						ac <= cell_addr;
+						ac_valid <= 1'b1;
+					end
+				end
+
+			S_SETUP:
+				if (timer == 32'd0) begin
+					e     <= 1'b1;
+					timer <= T_EH - 1;
+					state <= S_PULSE;
+				end else timer <= timer - 32'd1;
+
+			S_PULSE:
+				if (timer == 32'd0) begin
+					e     <= 1'b0;					// EN (1->0): the byte is taken
+					timer <= (!rs && data <= 8'd3) ? T_CLEAR - 1 : T_EXEC - 1;
+					state <= S_WAIT;
+				end else timer <= timer - 32'd1;
+
+			default:
+				if (timer == 32'd0) state <= S_IDLE;
+				else timer <= timer - 32'd1;
+		endcase
+
+		if (wr) begin
+			if (address < 5'd8) begin
+				for (i = 0; i < 4; i = i + 1)
+					if (text[{address[2:0], i[1:0]}] != writedata[8*i +: 8]) begin
+						text[{address[2:0], i[1:0]}] <= writedata[8*i +: 8];
+						text_dirty[{address[2:0], i[1:0]}] <= 1'b1;
+					end
+			end else if (address < 5'd24) begin
+				for (i = 0; i < 4; i = i + 1)
+					if (cgram[{cg_word, i[1:0]}] != writedata[8*i +: 5]) begin
+						cgram[{cg_word, i[1:0]}] <= writedata[8*i +: 5];
+						glyph_dirty[cg_word[3:1]] <= 1'b1;
+					end
+			end else if (address == 5'd24)
+				run <= writedata[0];
+		end
+	end
+
+//=======================================================
+//  One byte: RS and data, then setup, E pulse and
+//  execution wait
+//=======================================================
+task send(input byte_rs, input [7:0] byte_data);
+	begin
+		rs    <= byte_rs;
+		data  <= byte_data;
+		timer <= T_AS - 1;
+		state <= S_SETUP;
+	end
+endtask
+
+endmodule
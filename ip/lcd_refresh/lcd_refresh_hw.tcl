@@ -0,0 +1,89 @@
+# lcd_refresh "LCD Refresh" v1.0
+# Avalon-MM HD44780 controller for the LCD 1602, refreshed from a framebuffer
+
+package require -exact qsys 16.1
+
+#
+# module lcd_refresh
+#
+set_module_property DESCRIPTION "HD44780 controller that keeps the panel in step with a 2x16 text and 8-glyph CGRAM register file"
+set_module_property NAME lcd_refresh
+set_module_property VERSION 1.0
+set_module_property INTERNAL false
+set_module_property OPAQUE_ADDRESS_MAP true
+set_module_property GROUP "miniProject"
+set_module_property AUTHOR ""
+set_module_property DISPLAY_NAME "LCD Refresh"
+set_module_property INSTANTIATE_IN_SYSTEM_MODULE true
+set_module_property EDITABLE false
+set_module_property REPORT_TO_TALKBACK false
+set_module_property ALLOW_GREYBOX_GENERATION false
+set_module_property REPORT_HIERARCHY false
+
+#
+# parameters
+#
+add_parameter CLK_FREQ INTEGER 50000000
+set_parameter_property CLK_FREQ DISPLAY_NAME "Clock frequency"
+set_parameter_property CLK_FREQ UNITS Hertz
+set_parameter_property CLK_FREQ SYSTEM_INFO {CLOCK_RATE clock}
+set_parameter_property CLK_FREQ HDL_PARAMETER true
+set_parameter_property CLK_FREQ AFFECTS_GENERATION false
+
+#
+# file sets
+#
+add_fileset QUARTUS_SYNTH QUARTUS_SYNTH "" ""
+set_fileset_property QUARTUS_SYNTH TOP_LEVEL lcd_refresh
+add_fileset_file lcd_refresh.v VERILOG PATH lcd_refresh.v TOP_LEVEL_FILE
+
+add_fileset SIM_VERILOG SIM_VERILOG "" ""
+set_fileset_property SIM_VERILOG TOP_LEVEL lcd_refresh
+add_fileset_file lcd_refresh.v VERILOG PATH lcd_refresh.v
+
+#
+# connection point clock
+#
+add_interface clock clock end
+set_interface_property clock clockRate 0
+add_interface_port clock clk clk Input 1
+
+#
+# connection point reset
+#
+add_interface reset reset end
+set_interface_property reset associatedClock clock
+set_interface_property reset synchronousEdges DEASSERT
+add_interface_port reset reset_n reset_n Input 1
+
+#
+# connection point s1
+#
+add_interface s1 avalon end
+set_interface_property s1 addressUnits WORDS
+set_interface_property s1 associatedClock clock
+set_interface_property s1 associatedReset reset
+set_interface_property s1 explicitAddressSpan 0
+set_interface_property s1 maximumPendingReadTransactions 0
+set_interface_property s1 readLatency 0
+set_interface_property s1 readWaitTime 0
+set_interface_property s1 writeWaitTime 0
+set_interface_property s1 timingUnits Cycles
+set_interface_property s1 ENABLED true
+add_interface_port s1 address address Input 5
+add_interface_port s1 chipselect chipselect Input 1
+add_interface_port s1 write_n write_n Input 1
+add_interface_port s1 writedata writedata Input 32
+add_interface_port s1 readdata readdata Output 32
+set_interface_assignment s1 embeddedsw.configuration.isFlash 0
+set_interface_assignment s1 embeddedsw.configuration.isMemoryDevice 0
+set_interface_assignment s1 embeddedsw.configuration.isNonVolatileStorage 0
+set_interface_assignment s1 embeddedsw.configuration.isPrintableDevice 0
+
+#
+# connection point external_connection
+#
+add_interface external_connection conduit end
+set_interface_property external_connection associatedClock clock
+set_interface_property external_connection associatedReset reset
+add_interface_port external_connection lcd_out export Output 11
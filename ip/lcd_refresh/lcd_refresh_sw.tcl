@@ -0,0 +1,16 @@
+#
+# lcd_refresh_sw.tcl
+#
+# Register header only, no HAL device driver
+
+create_driver lcd_refresh_driver
+
+set_sw_property hw_class_name lcd_refresh
+set_sw_property version 1.0
+set_sw_property min_compatible_hw_version 1.0
+set_sw_property auto_initialize false
+set_sw_property bsp_subdirectory drivers
+
+add_sw_property include_source inc/lcd_refresh_regs.h
+
+add_sw_property supported_bsp_type HAL
@@ -0,0 +1,509 @@
+//=======================================================
+//  tb_lcd_refresh: self-checking testbench for
+//  lcd_refresh with a behavioural HD44780 on lcd_out
+//
+//  The model (hd44780 below) takes a byte on every
+//  falling E, keeps DDRAM, CGRAM and the address
+//  counter, logs every bus cycle and checks the write
+//  timing: power-on wait, RS/data setup, E pulse width,
+//  data stable while E is high and the execution time
+//  of the previous byte.
+//
+//  Checks that
+//    - the first RUN initialises the panel and sends
+//      every glyph and cell,
+//    - writing a value a cell already holds sends
+//      nothing, only changed cells make bus cycles,
+//    - consecutive dirty cells share one set-DDRAM,
+//      a skipped cell, the row change and a glyph
+//      upload make the core set the address again,
+//    - CGRAM word 8+2g / 9+2g lands in glyph g rows
+//      0..3 / 4..7 (cg_word) and reads back the same.
+//
+//  iverilog -g2005 -o tb_lcd_refresh tb_lcd_refresh.v lcd_refresh.v
+//  vvp tb_lcd_refresh
+//  verilator --binary --timing --top-module tb_lcd_refresh tb_lcd_refresh.v lcd_refresh.v
+//
+//  Prints PASS or FAIL with the error count, then $finish.
+//=======================================================
+
+`timescale 1ns / 1ps
+
+module tb_lcd_refresh;
+
+//=======================================================
+//  Register map (lcd_refresh.v)
+//=======================================================
+localparam REG_TEXT    = 5'd0;
+localparam REG_CGRAM   = 5'd8;
+localparam REG_CONTROL = 5'd24;
+localparam REG_STATUS  = 5'd25;
+
+localparam RS_CMD  = 1'b0;
+localparam RS_DATA = 1'b1;
+
+//=======================================================
+//  REG/WIRE declarations
+//=======================================================
+reg         clk, reset_n;
+reg  [4:0]  address;
+reg         chipselect, write_n;
+reg  [31:0] writedata;
+wire [31:0] readdata;
+wire [10:0] lcd_out;
+
+integer     errors;
+integer     i, k;
+
+reg   [7:0] text [0:31];				// what the panel should show
+reg   [4:0] glyph [0:63];				// glyph g row r at 8g + r
+reg   [8:0] expect_log [0:127];			// {rs, data} of the next bus cycles
+integer     expect_n;
+integer     mark;						// lcd.bytes before the writes
+
+lcd_refresh #(.CLK_FREQ(50000000)) dut (
+	.clk        (clk),
+	.reset_n    (reset_n),
+	.address    (address),
+	.chipselect (chipselect),
+	.write_n    (write_n),
+	.writedata  (writedata),
+	.readdata   (readdata),
+	.lcd_out    (lcd_out)
+);
+
+hd44780 lcd (
+	.reset_n    (reset_n),
+	.lcd_out    (lcd_out)
+);
+
+always #10 clk = ~clk;			// 50 MHz
+
+//=======================================================
+//  Avalon-MM master, readdata is combinational in the
+//  core
+//=======================================================
+task avalon_write(input [4:0] addr, input [31:0] data);
+begin
+	@(negedge clk);
+	address    = addr;
+	writedata  = data;
+	chipselect = 1'b1;
+	write_n    = 1'b0;
+	@(negedge clk);
+	chipselect = 1'b0;
+	write_n    = 1'b1;
+end
+endtask
+
+task avalon_read(input [4:0] addr, output [31:0] data);
+begin
+	@(negedge clk);
+	address    = addr;
+	chipselect = 1'b1;
+	#1;
+	data       = readdata;
+	chipselect = 1'b0;
+end
+endtask
+
+//=======================================================
+//  wait_idle: poll STATUS until BUSY clears, i.e. the
+//  last byte has also executed
+//=======================================================
+task wait_idle(input integer timeout_us);
+	reg [31:0] status;
+	integer t;
+begin
+	t = 0;
+	avalon_read(REG_STATUS, status);
+	while (status[0] && t < timeout_us) begin
+		repeat (50) @(posedge clk);
+		t = t + 1;
+		avalon_read(REG_STATUS, status);
+	end
+	if (status[0]) begin
+		$display("FAIL still busy after %0d us", timeout_us);
+		errors = errors + 1;
+	end
+end
+endtask
+
+//=======================================================
+//  Writes that keep the expected panel in step
+//=======================================================
+task write_text(input [2:0] word, input [31:0] data);
+begin
+	avalon_write(REG_TEXT + word, data);
+	for (k = 0; k < 4; k = k + 1)
+		text[4 * word + k] = data[8 * k +: 8];
+end
+endtask
+
+task write_cgram(input [3:0] word, input [31:0] data);
+begin
+	avalon_write(REG_CGRAM + word, data);
+	for (k = 0; k < 4; k = k + 1)
+		glyph[4 * word + k] = data[8 * k +: 5];	// word 2g + h holds glyph g rows 4h..4h+3
+end
+endtask
+
+//=======================================================
+//  Expected bus cycles since mark
+//=======================================================
+task expect_clear;
+begin
+	expect_n = 0;
+	mark     = lcd.bytes;
+end
+endtask
+
+task expect_byte(input rs, input [7:0] data);
+begin
+	expect_log[expect_n] = {rs, data};
+	expect_n = expect_n + 1;
+end
+endtask
+
+task expect_check(input [8*24-1:0] name);
+	integer n;
+begin
+	n = lcd.bytes - mark;
+	if (n != expect_n) begin
+		$display("FAIL %0s: %0d bus cycles, expected %0d", name, n, expect_n);
+		errors = errors + 1;
+	end
+	for (k = 0; k < n && k < expect_n; k = k + 1)
+		if (lcd.log[mark + k] !== expect_log[k]) begin
+			$display("FAIL %0s: cycle %0d RS=%0d 0x%02h, expected RS=%0d 0x%02h", name, k,
+			         lcd.log[mark + k][8], lcd.log[mark + k][7:0],
+			         expect_log[k][8], expect_log[k][7:0]);
+			errors = errors + 1;
+		end
+	if (n == expect_n)
+		$display("ok   %0s: %0d bus cycles", name, n);
+end
+endtask
+
+//=======================================================
+//  Panel contents against the expected ones
+//=======================================================
+task check_panel(input [8*24-1:0] name);
+	integer bad;
+begin
+	bad = 0;
+	for (i = 0; i < 32; i = i + 1)
+		if (lcd.ddram[{i[4], 2'b00, i[3:0]}] !== text[i]) bad = bad + 1;
+	for (i = 0; i < 64; i = i + 1)
+		if (lcd.cgram[i] !== glyph[i]) bad = bad + 1;
+	if (bad) begin
+		$display("FAIL %0s: %0d panel cells/glyph rows differ", name, bad);
+		errors = errors + 1;
+	end
+end
+endtask
+
+task check_cgram_read;
+	reg [31:0] data;
+begin
+	for (i = 0; i < 16; i = i + 1) begin
+		avalon_read(REG_CGRAM + i, data);
+		for (k = 0; k < 4; k = k + 1)
+			if (data[8 * k +: 8] !== {3'd0, glyph[4 * i + k]}) begin
+				$display("FAIL CGRAM word %0d row %0d read 0x%02h, expected 0x%02h",
+				         i, k, data[8 * k +: 8], glyph[4 * i + k]);
+				errors = errors + 1;
+			end
+	end
+end
+endtask
+
+//=======================================================
+//  Stimulus
+//=======================================================
+initial begin
+	clk        = 1'b0;
+	reset_n    = 1'b0;
+	address    = 5'd0;
+	chipselect = 1'b0;
+	write_n    = 1'b1;
+	writedata  = 32'd0;
+	errors     = 0;
+	for (i = 0; i < 32; i = i + 1) text[i]  = 8'h20;
+	for (i = 0; i < 64; i = i + 1) glyph[i] = 5'd0;
+
+	repeat (4) @(posedge clk);
+	reset_n = 1'b1;
+
+	// RUN: init, 8 glyphs, then row 0 and row 1 behind one
+	// set-DDRAM each
+	expect_clear;
+	avalon_write(REG_CONTROL, 32'd1);
+	wait_idle(60000);
+	expect_byte(RS_CMD, 8'h38);
+	expect_byte(RS_CMD, 8'h0C);
+	expect_byte(RS_CMD, 8'h06);
+	expect_byte(RS_CMD, 8'h01);
+	for (i = 0; i < 8; i = i + 1) begin
+		expect_byte(RS_CMD, 8'h40 | (i << 3));
+		for (k = 0; k < 8; k = k + 1) expect_byte(RS_DATA, 8'h00);
+	end
+	expect_byte(RS_CMD, 8'h80);
+	for (i = 0; i < 16; i = i + 1) expect_byte(RS_DATA, 8'h20);
+	expect_byte(RS_CMD, 8'hC0);
+	for (i = 0; i < 16; i = i + 1) expect_byte(RS_DATA, 8'h20);
+	expect_check("run");
+	check_panel("run");
+
+	// values the cells already hold: no bus cycle at all
+	expect_clear;
+	write_text(0, 32'h20202020);
+	write_text(5, 32'h20202020);
+	write_cgram(0, 32'h00000000);
+	write_cgram(15, 32'hE0E0E0E0);			// only bits above the 5 pixels
+	repeat (200) @(posedge clk);
+	wait_idle(1000);
+	expect_check("unchanged");
+
+	// cells 2, 3 and 6: 2 and 3 share the set-DDRAM, 4 and 5
+	// are skipped so 6 needs its own
+	expect_clear;
+	write_text(0, 32'h42412020);			// cells 3..0 = 'B' 'A' ' ' ' '
+	write_text(1, 32'h20432020);			// cell 6 = 'C'
+	wait_idle(1000);
+	expect_byte(RS_CMD,  8'h82);
+	expect_byte(RS_DATA, 8'h41);
+	expect_byte(RS_DATA, 8'h42);
+	expect_byte(RS_CMD,  8'h86);
+	expect_byte(RS_DATA, 8'h43);
+	expect_check("skipped cells");
+	check_panel("skipped cells");
+
+	// cells 15 and 16 are neighbours in TEXT but not in DDRAM
+	expect_clear;
+	write_text(3, 32'h44202020);			// cell 15 = 'D'
+	write_text(4, 32'h20202045);			// cell 16 = 'E'
+	wait_idle(1000);
+	expect_byte(RS_CMD,  8'h8F);
+	expect_byte(RS_DATA, 8'h44);
+	expect_byte(RS_CMD,  8'hC0);
+	expect_byte(RS_DATA, 8'h45);
+	expect_check("row change");
+	check_panel("row change");
+
+	// a run of changed cells on row 1 goes out behind one
+	// set-DDRAM
+	expect_clear;
+	write_text(7, 32'h34333231);			// cells 28..31 = "1234"
+	wait_idle(1000);
+	expect_byte(RS_CMD,  8'hCC);
+	for (i = 0; i < 4; i = i + 1) expect_byte(RS_DATA, 8'h31 + i);
+	expect_check("row 1 run");
+	check_panel("row 1 run");
+
+	// cg_word: word 8+2g is glyph g rows 0..3, 9+2g rows
+	// 4..7. Glyphs 0, 3 and 7 cover both ends of the map.
+	// Cell 8 goes first and keeps the core busy with its
+	// set-DDRAM, so all six words land before the glyphs
+	// are sent; the glyphs then clear the address and the
+	// cell needs a second set-DDRAM
+	expect_clear;
+	write_text(2, 32'h20202047);			// cell 8 = 'G'
+	write_cgram(0,  32'h04030201);
+	write_cgram(1,  32'h08070605);
+	write_cgram(6,  32'h1F0E1B11);
+	write_cgram(7,  32'h0A15000F);
+	write_cgram(14, 32'h13121110);
+	write_cgram(15, 32'h17161514);
+	wait_idle(2000);
+	expect_byte(RS_CMD, 8'h88);
+	for (i = 0; i < 8; i = i + 1)
+		if (i == 0 || i == 3 || i == 7) begin
+			expect_byte(RS_CMD, 8'h40 | (i << 3));
+			for (k = 0; k < 8; k = k + 1) expect_byte(RS_DATA, {3'd0, glyph[8 * i + k]});
+		end
+	expect_byte(RS_CMD,  8'h88);
+	expect_byte(RS_DATA, 8'h47);
+	expect_check("cg_word");
+	check_panel("cg_word");
+	check_cgram_read;
+
+	// one changed row still uploads the whole glyph
+	expect_clear;
+	write_cgram(13, 32'h0000001F);			// glyph 6 row 4
+	wait_idle(1000);
+	expect_byte(RS_CMD, 8'h70);
+	for (k = 0; k < 8; k = k + 1) expect_byte(RS_DATA, {3'd0, glyph[48 + k]});
+	expect_check("glyph row");
+	check_panel("glyph row");
+
+	// after a glyph the address counter is in CGRAM: cell 0
+	// gets its set-DDRAM, glyph 1 and cell 1 are written
+	// meanwhile, the glyph goes first and cell 0 needs the
+	// address again
+	expect_clear;
+	write_text(0, 32'h42412021);			// cell 0 = '!'
+	write_cgram(2, 32'h00000001);			// glyph 1 row 0
+	write_text(0, 32'h42412121);			// cell 1 = '!'
+	wait_idle(1000);
+	expect_byte(RS_CMD, 8'h80);
+	expect_byte(RS_CMD, 8'h48);
+	for (k = 0; k < 8; k = k + 1) expect_byte(RS_DATA, {3'd0, glyph[8 + k]});
+	expect_byte(RS_CMD,  8'h80);
+	expect_byte(RS_DATA, 8'h21);
+	expect_byte(RS_DATA, 8'h21);
+	expect_check("ddram after glyph");
+	check_panel("ddram after glyph");
+
+	// RUN cleared and set again: everything is sent again
+	expect_clear;
+	avalon_write(REG_CONTROL, 32'd0);
+	repeat (10) @(posedge clk);
+	avalon_write(REG_CONTROL, 32'd1);
+	wait_idle(10000);
+	if (lcd.bytes - mark != 110) begin
+		$display("FAIL restart: %0d bus cycles, expected 110", lcd.bytes - mark);
+		errors = errors + 1;
+	end else
+		$display("ok   restart: 110 bus cycles");
+	check_panel("restart");
+
+	errors = errors + lcd.errors;
+	if (errors == 0)
+		$display("PASS");
+	else
+		$display("FAIL: %0d errors", errors);
+	$finish;
+end
+
+endmodule
+
+//=======================================================
+//  hd44780: behavioural HD44780 write side, 8-bit bus
+//
+//  lcd_out = {RS, RW, E, D7..D0}. A byte is taken on
+//  the falling E. Timing limits from the datasheet
+//  (Vcc 4.5-5.5V): power-on 15 ms, tAS 40 ns, PWEH
+//  230 ns (450 ns used by the core), execution 37 us,
+//  clear/home 1.52 ms.
+//=======================================================
+module hd44780 (
+	input         reset_n,
+	input  [10:0] lcd_out
+);
+
+localparam integer T_POWER_NS = 15000000;
+localparam integer T_AS_NS    = 40;
+localparam integer T_EH_NS    = 230;
+localparam integer T_EXEC_NS  = 37000;
+localparam integer T_CLEAR_NS = 1520000;
+
+wire        rs   = lcd_out[10];
+wire        rw   = lcd_out[9];
+wire        e    = lcd_out[8];
+wire  [7:0] data = lcd_out[7:0];
+
+reg   [7:0] ddram [0:127];
+reg   [4:0] cgram [0:63];
+reg   [6:0] ac;
+reg         ac_cg;						// address counter points into CGRAM
+reg   [8:0] log [0:1023];				// {rs, data} of every bus cycle
+integer     bytes, errors, i;
+
+time        t_power, t_change, t_rise, t_fall, t_exec;
+
+initial begin
+	bytes  = 0;
+	errors = 0;
+	ac     = 7'd0;
+	ac_cg  = 1'b0;
+	t_fall = 0;
+	t_exec = 0;
+	for (i = 0; i < 128; i = i + 1) ddram[i] = 8'hxx;
+	for (i = 0; i < 64; i = i + 1)  cgram[i] = 5'bxxxxx;
+end
+
+always @(posedge reset_n) t_power = $time;
+
+// RS and data must hold while E is high
+always @(rs or data) begin
+	t_change = $time;
+	if (e) begin
+		$display("LCD FAIL RS/data changed while E high at %0t", $time);
+		errors = errors + 1;
+	end
+end
+
+always @(rw)
+	if (rw !== 1'b0) begin
+		$display("LCD FAIL RW=%b at %0t", rw, $time);
+		errors = errors + 1;
+	end
+
+always @(posedge e) if (reset_n === 1'b1) begin
+	t_rise = $time;
+	if (bytes == 0 && t_rise - t_power < T_POWER_NS) begin
+		$display("LCD FAIL first byte %0t ns after power-on", t_rise - t_power);
+		errors = errors + 1;
+	end
+	if (t_rise - t_change < T_AS_NS) begin
+		$display("LCD FAIL setup %0t ns", t_rise - t_change);
+		errors = errors + 1;
+	end
+	if (bytes != 0 && t_rise - t_fall < t_exec) begin
+		$display("LCD FAIL byte %0d %0t ns after the last, needs %0t", bytes, t_rise - t_fall, t_exec);
+		errors = errors + 1;
+	end
+end
+
+always @(negedge e) if (reset_n === 1'b1) begin
+	t_fall = $time;
+	if (t_fall - t_rise < T_EH_NS) begin
+		$display("LCD FAIL E high %0t ns", t_fall - t_rise);
+		errors = errors + 1;
+	end
+	if (bytes < 1024) log[bytes] = {rs, data};
+	bytes  = bytes + 1;
+	t_exec = T_EXEC_NS;
+
+	if (rs) begin
+		if (ac_cg) begin
+			cgram[ac[5:0]] = data[4:0];
+			ac = {1'b0, ac[5:0] + 6'd1};
+		end else begin
+			ddram[ac] = data;
+			ac = ac + 7'd1;
+		end
+	end else if (data[7]) begin				// set DDRAM address
+		ac    = data[6:0];
+		ac_cg = 1'b0;
+	end else if (data[6]) begin				// set CGRAM address
+		ac    = {1'b0, data[5:0]};
+		ac_cg = 1'b1;
+	end else if (data[5]) begin				// function set
+		if (data[4:3] != 2'b11) begin
+			$display("LCD FAIL function set 0x%02h, not 8 bit 2 lines", data);
+			errors = errors + 1;
+		end
+	end else if (data[4]) begin				// cursor/display shift, unused
+		$display("LCD FAIL shift command 0x%02h", data);
+		errors = errors + 1;
+	end else if (data[3]) begin				// display control
+	end else if (data[2]) begin				// entry mode
+		if (data[1:0] != 2'b10) begin
+			$display("LCD FAIL entry mode 0x%02h, not increment", data);
+			errors = errors + 1;
+		end
+	end else if (data[1]) begin				// return home
+		ac     = 7'd0;
+		ac_cg  = 1'b0;
+		t_exec = T_CLEAR_NS;
+	end else if (data[0]) begin				// clear display
+		for (i = 0; i < 128; i = i + 1) ddram[i] = 8'h20;
+		ac     = 7'd0;
+		ac_cg  = 1'b0;
+		t_exec = T_CLEAR_NS;
+	end
+end
+
+endmodule
@@ -0,0 +1,158 @@
+//=======================================================
+//  motor_pwm: Avalon-MM PWM generator for the L298
+//
+//  Two channels (A, B) share one period counter.
+//
+//  Registers (32-bit, word offsets):
+//    0 PERIOD     clocks per PWM period (0 stops the output)
+//    1 COMPARE    clocks channel A stays high per period
+//                 (>= PERIOD gives 100%)
+//    2 OUTPUT     pwm_out pattern per channel level:
+//                   [3:0]   while A is high  [7:4]   while A is low
+//                   [11:8]  while B is high  [15:12] while B is low
+//                 the A and B patterns are ORed
+//    3 ENABLE     bit 0: run, 0 forces pwm_out low
+//                 bit 1: HOLD, the running settings are
+//                 kept (the period repeats) while set
+//    4 COMPARE_B  clocks channel B stays high per period
+//    5 DITHER     [15:0] fraction of a clock for channel A:
+//                 added to an accumulator at every period
+//                 start, a carry makes that period's HIGH
+//                 one clock longer (first-order sigma-delta)
+//    6 DITHER_B   the same for channel B
+//
+//  PERIOD, COMPARE, COMPARE_B and OUTPUT are taken over
+//  at the end of a period (and on enable), so a write
+//  never produces a short or long pulse and a duty and
+//  pattern change land on the same edge. Setting HOLD
+//  around several writes (PERIOD with both COMPAREs for
+//  a frequency change) makes them land together.
+//=======================================================
+
+module motor_pwm (
+	input              clk,
+	input              reset_n,
+
+	input       [2:0]  address,
+	input              chipselect,
+	input              write_n,
+	input      [31:0]  writedata,
+	output reg [31:0]  readdata,
+
+	output reg  [3:0]  pwm_out
+);
+
+//=======================================================
+//  REG/WIRE declarations
+//=======================================================
+reg  [31:0] period, compare, compare_b;				// written by the CPU
+reg  [31:0] period_act, compare_act, compare_b_act;	// used by the running period
+reg  [15:0] outsel, outsel_act;
+reg  [15:0] dither, dither_b;			// written by the CPU
+reg  [15:0] acc, acc_b;					// sigma-delta accumulators
+reg         enable, hold, running;
+reg  [31:0] counter;
+reg         level, level_b;
+
+wire        wr   = chipselect & ~write_n;
+wire        last = (counter >= period_act - 32'd1);
+
+// next accumulator values, bit 16 is the carry into COMPARE
+wire [16:0] acc_sum   = {1'b0, acc}   + {1'b0, dither};
+wire [16:0] acc_b_sum = {1'b0, acc_b} + {1'b0, dither_b};
+wire [31:0] compare_next   = compare   + acc_sum[16];
+wire [31:0] compare_b_next = compare_b + acc_b_sum[16];
+
+//=======================================================
+//  Avalon-MM slave
+//=======================================================
+always @(posedge clk or negedge reset_n)
+	if (!reset_n) begin
+		period    <= 32'd0;
+		compare   <= 32'd0;
+		compare_b <= 32'd0;
+		outsel    <= 16'd0;
+		dither    <= 16'd0;
+		dither_b  <= 16'd0;
+		enable    <= 1'b0;
+		hold      <= 1'b0;
+	end else if (wr) begin
+		case (address)
+			3'd0: period    <= writedata;
+			3'd1: compare   <= writedata;
+			3'd2: outsel    <= writedata[15:0];
+			3'd3: {hold, enable} <= writedata[1:0];
+			3'd4: compare_b <= writedata;
+			3'd5: dither    <= writedata[15:0];
+			3'd6: dither_b  <= writedata[15:0];
+		endcase
+	end
+
+always @(*)
+	case (address)
+		3'd0:    readdata = period;
+		3'd1:    readdata = compare;
+		3'd2:    readdata = {16'd0, outsel};
+		3'd3:    readdata = {30'd0, hold, enable};
+		3'd4:    readdata = compare_b;
+		3'd5:    readdata = {16'd0, dither};
+		default: readdata = {16'd0, dither_b};
+	endcase
+
+//=======================================================
+//  Counter and compare
+//=======================================================
+always @(posedge clk or negedge reset_n)
+	if (!reset_n) begin
+		running       <= 1'b0;
+		counter       <= 32'd0;
+		period_act    <= 32'd0;
+		compare_act   <= 32'd0;
+		compare_b_act <= 32'd0;
+		outsel_act    <= 16'd0;
+		acc           <= 16'd0;
+		acc_b         <= 16'd0;
+		level         <= 1'b0;
+		level_b       <= 1'b0;
+	end else if (!enable || period == 32'd0) begin
+		running <= 1'b0;
+		counter <= 32'd0;
+		level   <= 1'b0;
+		level_b <= 1'b0;
+	end else if (running && last && hold) begin
+		// HOLD: repeat the running period unchanged
+		counter <= 32'd0;
+		level   <= (compare_act != 32'd0);
+		level_b <= (compare_b_act != 32'd0);
+	end else if (!running || last) begin
+		// first clock of a period: latch the new settings
+		running       <= 1'b1;
+		counter       <= 32'd0;
+		period_act    <= period;
+		compare_act   <= compare_next;
+		compare_b_act <= compare_b_next;
+		outsel_act    <= outsel;
+		acc           <= acc_sum[15:0];
+		acc_b         <= acc_b_sum[15:0];
+		level         <= (compare_next != 32'd0);
+		level_b       <= (compare_b_next != 32'd0);
+	end else begin
+		counter <= counter + 32'd1;
+		level   <= (counter + 32'd1 < compare_act);
+		level_b <= (counter + 32'd1 < compare_b_act);
+	end
+
+//=======================================================
+//  Output: one registered pattern per edge, all four
+//  pins change on the same clock
+//=======================================================
+always @(posedge clk or negedge reset_n)
+	if (!reset_n)
+		pwm_out <= 4'd0;
+	else if (!running)
+		pwm_out <= 4'd0;
+	else
+		pwm_out <= (level   ? outsel_act[3:0]  : outsel_act[7:4]) |
+		           (level_b ? outsel_act[11:8] : outsel_act[15:12]);
+
+endmodule
@@ -0,0 +1,16 @@
+#
+# motor_pwm_sw.tcl
+#
+# Register header only, no HAL device driver
+
+create_driver motor_pwm_driver
+
+set_sw_property hw_class_name motor_pwm
+set_sw_property version 1.0
+set_sw_property min_compatible_hw_version 1.0
+set_sw_property auto_initialize false
+set_sw_property bsp_subdirectory drivers
+
+add_sw_property include_source inc/motor_pwm_regs.h
+
+add_sw_property supported_bsp_type HAL
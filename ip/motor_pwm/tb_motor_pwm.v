@@ -0,0 +1,262 @@
+//=======================================================
+//  tb_motor_pwm: self-checking testbench for motor_pwm
+//
+//  Programs the core over its Avalon-MM slave at 1, 10,
+//  20 and 50 kHz (50 MHz clock), counts the clocks each
+//  pwm_out pin is high over whole periods and compares
+//  them with PERIOD/COMPARE/COMPARE_B. Also covers the
+//  OUTPUT patterns, ENABLE, HOLD, DITHER and DITHER_B.
+//
+//  OUTPUT = 0x8421 puts every channel level on its own
+//  pin: pwm_out[0] A high, [1] A low, [2] B high, [3] B low.
+//
+//  iverilog -g2005 -o tb_motor_pwm tb_motor_pwm.v motor_pwm.v
+//  vvp tb_motor_pwm
+//  verilator --binary --timing --top-module tb_motor_pwm tb_motor_pwm.v motor_pwm.v
+//
+//  Prints PASS or FAIL with the error count, then $finish.
+//=======================================================
+
+`timescale 1ns / 1ps
+
+module tb_motor_pwm;
+
+//=======================================================
+//  Register map (motor_pwm.v)
+//=======================================================
+localparam REG_PERIOD    = 3'd0;
+localparam REG_COMPARE   = 3'd1;
+localparam REG_OUTPUT    = 3'd2;
+localparam REG_ENABLE    = 3'd3;
+localparam REG_COMPARE_B = 3'd4;
+localparam REG_DITHER    = 3'd5;
+localparam REG_DITHER_B  = 3'd6;
+
+localparam CLK_HZ  = 50000000;
+localparam PATTERN = 32'h8421;
+
+//=======================================================
+//  REG/WIRE declarations
+//=======================================================
+reg         clk, reset_n;
+reg  [2:0]  address;
+reg         chipselect, write_n;
+reg  [31:0] writedata;
+wire [31:0] readdata;
+wire [3:0]  pwm_out;
+
+integer     errors;
+integer     cur_period;			// PERIOD the core is running with
+integer     high_a, low_a, high_b, low_b;
+
+motor_pwm dut (
+	.clk        (clk),
+	.reset_n    (reset_n),
+	.address    (address),
+	.chipselect (chipselect),
+	.write_n    (write_n),
+	.writedata  (writedata),
+	.readdata   (readdata),
+	.pwm_out    (pwm_out)
+);
+
+always #10 clk = ~clk;			// 50 MHz
+
+//=======================================================
+//  Avalon-MM master: one write per clock, readdata is
+//  combinational in the core
+//=======================================================
+task avalon_write(input [2:0] addr, input [31:0] data);
+begin
+	@(negedge clk);
+	address    = addr;
+	writedata  = data;
+	chipselect = 1'b1;
+	write_n    = 1'b0;
+	@(negedge clk);
+	chipselect = 1'b0;
+	write_n    = 1'b1;
+end
+endtask
+
+task avalon_check(input [2:0] addr, input [31:0] value);
+begin
+	@(negedge clk);
+	address    = addr;
+	chipselect = 1'b1;
+	#1;
+	if (readdata !== value) begin
+		$display("FAIL reg %0d read 0x%08h, expected 0x%08h", addr, readdata, value);
+		errors = errors + 1;
+	end
+	chipselect = 1'b0;
+end
+endtask
+
+//=======================================================
+//  set_pwm: PERIOD and both COMPAREs under HOLD so they
+//  are latched on the same period edge, then wait until
+//  the old period has ended and one new one has run
+//=======================================================
+task set_pwm(input integer period, input integer compare, input integer compare_b);
+	integer wait_clocks;
+begin
+	avalon_write(REG_ENABLE,    32'd3);		// run + HOLD
+	avalon_write(REG_PERIOD,    period);
+	avalon_write(REG_COMPARE,   compare);
+	avalon_write(REG_COMPARE_B, compare_b);
+	avalon_write(REG_ENABLE,    32'd1);		// release
+	avalon_check(REG_PERIOD,    period);
+	avalon_check(REG_COMPARE,   compare);
+	avalon_check(REG_COMPARE_B, compare_b);
+	wait_clocks = 2 * (cur_period + period);
+	cur_period  = period;
+	repeat (wait_clocks) @(posedge clk);
+end
+endtask
+
+//=======================================================
+//  measure: level of every pin over a window of whole
+//  periods. Any window that long holds the same number
+//  of high clocks, so it need not start on an edge
+//=======================================================
+task measure(input integer clocks);
+begin
+	high_a = 0; low_a = 0; high_b = 0; low_b = 0;
+	repeat (clocks) begin
+		@(posedge clk);
+		if (pwm_out[0]) high_a = high_a + 1;
+		if (pwm_out[1]) low_a  = low_a  + 1;
+		if (pwm_out[2]) high_b = high_b + 1;
+		if (pwm_out[3]) low_b  = low_b  + 1;
+	end
+end
+endtask
+
+//=======================================================
+//  check_duty: n periods, expected high clocks per
+//  channel (COMPARE >= PERIOD gives 100%)
+//=======================================================
+task check_duty(input [8*16-1:0] name, input integer n, input integer exp_a, input integer exp_b);
+	integer window;
+begin
+	window = n * cur_period;
+	measure(window);
+	if (high_a != exp_a || low_a != window - exp_a ||
+	    high_b != exp_b || low_b != window - exp_b) begin
+		$display("FAIL %0s: %0d kHz A high %0d low %0d (expected %0d), B high %0d low %0d (expected %0d)",
+		         name, CLK_HZ / cur_period / 1000, high_a, low_a, exp_a, high_b, low_b, exp_b);
+		errors = errors + 1;
+	end else
+		$display("ok   %0s: %0d kHz A %0d/%0d B %0d/%0d clocks",
+		         name, CLK_HZ / cur_period / 1000, high_a, window, high_b, window);
+end
+endtask
+
+task check_off(input [8*16-1:0] name, input integer clocks);
+begin
+	measure(clocks);
+	if (high_a || low_a || high_b || low_b) begin
+		$display("FAIL %0s: pwm_out not low (A %0d/%0d B %0d/%0d)", name, high_a, low_a, high_b, low_b);
+		errors = errors + 1;
+	end else
+		$display("ok   %0s: pwm_out low", name);
+end
+endtask
+
+function integer clamp(input integer compare, input integer period);
+	clamp = compare > period ? period : compare;
+endfunction
+
+//=======================================================
+//  duty sweep at one frequency: 0, 25, 50 and 100% on A
+//  with B on the complement, then COMPARE > PERIOD
+//=======================================================
+task sweep(input integer freq);
+	integer p, d, c;
+begin
+	p = CLK_HZ / freq;
+	for (d = 0; d <= 100; d = d + 25) begin
+		c = p * d / 100;
+		set_pwm(p, c, p - c);
+		check_duty("duty", 2, 2 * c, 2 * (p - c));
+	end
+	set_pwm(p, p + 7, 1);
+	check_duty("compare>period", 2, 2 * clamp(p + 7, p), 2);
+end
+endtask
+
+//=======================================================
+//  Stimulus
+//=======================================================
+initial begin
+	clk        = 1'b0;
+	reset_n    = 1'b0;
+	address    = 3'd0;
+	chipselect = 1'b0;
+	write_n    = 1'b1;
+	writedata  = 32'd0;
+	errors     = 0;
+	cur_period = 0;
+
+	repeat (4) @(posedge clk);
+	reset_n = 1'b1;
+
+	// reset state, pins low while disabled
+	avalon_check(REG_PERIOD, 32'd0);
+	avalon_check(REG_ENABLE, 32'd0);
+	avalon_write(REG_OUTPUT, PATTERN);
+	avalon_check(REG_OUTPUT, PATTERN);
+	avalon_write(REG_PERIOD, CLK_HZ / 50000);
+	avalon_write(REG_COMPARE, 32'd500);
+	check_off("reset/disabled", 2000);
+
+	// duty over the frequency range of pwm_set_freq()
+	sweep(1000);
+	sweep(10000);
+	sweep(20000);
+	sweep(50000);
+
+	// HOLD: new COMPAREs are not taken while it is set
+	set_pwm(CLK_HZ / 20000, 625, 1875);
+	avalon_write(REG_ENABLE, 32'd3);
+	avalon_check(REG_ENABLE, 32'd3);
+	avalon_write(REG_COMPARE, 32'd2000);
+	avalon_write(REG_COMPARE_B, 32'd100);
+	repeat (2 * cur_period) @(posedge clk);
+	check_duty("hold", 4, 4 * 625, 4 * 1875);
+	avalon_write(REG_ENABLE, 32'd1);
+	repeat (2 * cur_period) @(posedge clk);
+	check_duty("hold released", 4, 4 * 2000, 4 * 100);
+
+	// ENABLE = 0 forces the pins low, the settings survive
+	avalon_write(REG_ENABLE, 32'd0);
+	repeat (2) @(posedge clk);
+	check_off("disable", 3 * cur_period);
+	avalon_write(REG_ENABLE, 32'd1);
+	repeat (2 * cur_period) @(posedge clk);
+	check_duty("re-enable", 2, 2 * 2000, 2 * 100);
+
+	// DITHER: 0x4000 is one extra clock every 4 periods,
+	// 0x8000 one every 2
+	set_pwm(CLK_HZ / 50000, 300, 700);
+	avalon_write(REG_DITHER,   32'h4000);
+	avalon_write(REG_DITHER_B, 32'h8000);
+	avalon_check(REG_DITHER,   32'h4000);
+	avalon_check(REG_DITHER_B, 32'h8000);
+	repeat (2 * cur_period) @(posedge clk);
+	check_duty("dither", 4, 4 * 300 + 1, 4 * 700 + 2);
+	check_duty("dither", 8, 8 * 300 + 2, 8 * 700 + 4);
+	avalon_write(REG_DITHER,   32'd0);
+	avalon_write(REG_DITHER_B, 32'd0);
+	repeat (2 * cur_period) @(posedge clk);
+	check_duty("dither off", 4, 4 * 300, 4 * 700);
+
+	if (errors == 0)
+		$display("PASS");
+	else
+		$display("FAIL: %0d errors", errors);
+	$finish;
+end
+
+endmodule
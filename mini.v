@@ -60,15 +60,49 @@ wire [1:0] DQM;
 assign DRAM_LDQM = DQM[0];
 assign DRAM_UDQM = DQM[1];
 
+// MOTOR_HW_PWM: GPIO[1..4] come from the motor_pwm_0 core. Without it they
+// come from the MOTOR PIO (timer_2 software PWM); PWM_USE_HW in
+// software/final/pwm.h must match.
+// Bits 0..3 are the L298 inputs IN1..IN4 (GPIO[4]..GPIO[1]), channel A on
+// IN1/IN2 and channel B on IN3/IN4, ENA/ENB jumpered high (hbridge.h).
+`define MOTOR_HW_PWM
+
+wire [3:0] motor_pio, motor_pwm;
+`ifdef MOTOR_HW_PWM
+assign {GPIO[1],GPIO[2],GPIO[3],GPIO[4]} = motor_pwm;
+`else
+assign {GPIO[1],GPIO[2],GPIO[3],GPIO[4]} = motor_pio;
+`endif
+
+// LCD_HW_REFRESH: the LCD pins come from the lcd_refresh_0 core, which sends
+// its framebuffer to the panel by itself. Without it they come from the LCD
+// PIO; LCD_USE_HW in software/final/lcd.h must match.
+`define LCD_HW_REFRESH
+
+wire [10:0] lcd_pio, lcd_refresh;
+`ifdef LCD_HW_REFRESH
+assign {GPIO[23],GPIO[24],GPIO[25],GPIO[35],GPIO[33],GPIO[31],GPIO[29],GPIO[34],GPIO[32],GPIO[30],GPIO[28]} = lcd_refresh;
+`endif
+
+// lcd_wire is bidirectional: D7..D0 are read back for the HD44780 busy flag
+// (LCD_BUSY_POLL in software/final/lcd.h). The panel drives them while RW=1,
+// so it must run at 3.3V or the data lines need level shifting.
 
 //=======================================================
 //  Structural coding
 //=======================================================
 miniProject (
 		.clk_clk(CLOCK_50),            //         clk.clk
+`ifdef LCD_HW_REFRESH
+		.lcd_wire_export(lcd_pio),    //    lcd_wire.export
+`else
 		.lcd_wire_export({GPIO[23],GPIO[24],GPIO[25],GPIO[35],GPIO[33],GPIO[31],GPIO[29],GPIO[34],GPIO[32],GPIO[30],GPIO[28]}),    //    lcd_wire.export
+`endif
+		.lcd_refresh_wire_export(lcd_refresh),    //    lcd_refresh_wire.export
+		.hex_wire_export({HEX5,HEX4,HEX3,HEX2,HEX1,HEX0}),    //    hex_wire.export (active low)
 		.led_wire_export(LEDR),    //    led_wire.export
-		.motor_wire_export({GPIO[1],GPIO[2],GPIO[3],GPIO[4]}),  //  motor_wire.export
+		.motor_wire_export(motor_pio),  //  motor_wire.export
+		.pwm_wire_export(motor_pwm),    //    pwm_wire.export
 		.reset_reset(1'b0),        //       reset.reset
 		.sdram_clk_clk(DRAM_CLK),      //   sdram_clk.clk
 		.sdram_wire_addr(DRAM_ADDR),    //  sdram_wire.addr
@@ -80,7 +114,8 @@ miniProject (
 		.sdram_wire_dqm(DQM),     //            .dqm
 		.sdram_wire_ras_n(DRAM_RAS_N),   //            .ras_n
 		.sdram_wire_we_n(DRAM_WE_N),    //            .we_n
-		.switch_wire_export(SW) // switch_wire.export
+		.switch_wire_export(SW), // switch_wire.export
+		.tach_wire_export(GPIO[5])  //   tach_wire.export (motor tachometer)
 	);
 
 
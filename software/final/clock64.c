@@ -0,0 +1,74 @@
+#include <stddef.h>
+#include <altera_avalon_timer_regs.h>
+#include <sys/alt_irq.h>
+#include <sys/alt_timestamp.h>
+#include <system.h>
+#include "clock64.h"
+
+/*------------------------------------------------/
+ Name:				variables
+ Description: written by the wrap ISR only,
+ 	 	 	  clock64_seq is odd during an update
+ ------------------------------------------------*/
+
+static volatile alt_u32 clock64_hi;
+static volatile alt_u32 clock64_seq;
+
+/*------------------------------------------------/
+ Name:				clock64_isr
+ Description: timer_1 wrapped: one more 2^32
+ 	 	 	  cycles in the upper word
+ ------------------------------------------------*/
+
+static void clock64_isr(void* context)
+{
+	IOWR_ALTERA_AVALON_TIMER_STATUS(CLOCK64_BASE, 0);
+	clock64_seq++;
+	clock64_hi++;
+	clock64_seq++;
+}
+
+/*------------------------------------------------/
+ Name:				clock64_init
+ Description: start timer_1 at 0 in continuous
+ 	 	 	  mode with the wrap interrupt. Replaces
+ 	 	 	  alt_timestamp_start(), which leaves it
+ 	 	 	  stopped at the first wrap
+ ------------------------------------------------*/
+
+void clock64_init(void)
+{
+	clock64_hi = 0;
+	clock64_seq = 0;
+
+	alt_timestamp_start();
+	IOWR_ALTERA_AVALON_TIMER_STATUS(CLOCK64_BASE, 0);
+	IOWR_ALTERA_AVALON_TIMER_CONTROL(CLOCK64_BASE,
+			ALTERA_AVALON_TIMER_CONTROL_ITO_MSK |
+			ALTERA_AVALON_TIMER_CONTROL_CONT_MSK |
+			ALTERA_AVALON_TIMER_CONTROL_START_MSK);
+	alt_ic_isr_register(CLOCK64_IRQ_IC, CLOCK64_IRQ, clock64_isr, NULL, NULL);
+}
+
+/*------------------------------------------------/
+ Name:				clock64_now
+ Description: cycles since clock64_init(). The low
+ 	 	 	  word is sampled before TO, so a wrap
+ 	 	 	  seen in TO but not in the ISR count
+ 	 	 	  belongs to it if it is small
+ ------------------------------------------------*/
+
+alt_u64 clock64_now(void)
+{
+	alt_u32 seq, lo, hi, wrapped;
+
+	do {
+		seq = clock64_seq;
+		lo = alt_timestamp();
+		wrapped = IORD_ALTERA_AVALON_TIMER_STATUS(CLOCK64_BASE) & ALTERA_AVALON_TIMER_STATUS_TO_MSK;
+		hi = clock64_hi;
+	} while ((seq & 1) || seq != clock64_seq);
+
+	if (wrapped && lo < 0x80000000) hi++;	// interrupt still pending
+	return (alt_u64)hi << 32 | lo;
+}
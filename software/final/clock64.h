@@ -0,0 +1,60 @@
+#ifndef CLOCK64_H_
+#define CLOCK64_H_
+
+#include <alt_types.h>
+#include <system.h>
+#include "fixmath.h"
+
+/*###################################################
+ 	 	 	 	 64-BIT MONOTONIC CLOCK
+- timer_1 counts every clock in continuous mode and
+  wraps every 2^32 cycles (86s at 50MHz). Its
+  timeout interrupt (IRQ 0) counts the wraps in the
+  upper 32 bits, so clock64_now() never aliases
+- Lock-free read: the ISR bumps a sequence number
+  around the update and the reader retries if it
+  changed. A wrap whose interrupt is still pending
+  (reader with interrupts off) is taken from the
+  timer's TO bit
+- alt_timestamp() keeps working: it is the low 32
+  bits, for the 32-bit deadlines of sched.c
+- Conversions multiply, they never divide
+###################################################*/
+
+#define CLOCK64_BASE		TIMER_1_BASE
+#define CLOCK64_IRQ			TIMER_1_IRQ
+#define CLOCK64_IRQ_IC		TIMER_1_IRQ_INTERRUPT_CONTROLLER_ID
+#define CLOCK64_CLK			TIMER_1_FREQ					// timestamp clock
+
+#if (1000000000 % CLOCK64_CLK) || (CLOCK64_CLK % 1000000)
+#error "clock64: the clock must be a whole number of MHz that divides 1GHz"
+#endif
+
+#define CLOCK64_NS_PER_CYCLE	(1000000000 / CLOCK64_CLK)	// 20
+#define CLOCK64_CYCLES_PER_US	(CLOCK64_CLK / 1000000)		// 50
+
+void clock64_init(void);
+alt_u64 clock64_now(void);
+
+/*------------------------------------------------/
+ Name:				clock64_to_ns
+ Description: cycles in nanoseconds
+ ------------------------------------------------*/
+
+static ALT_INLINE alt_u64 clock64_to_ns(alt_u64 cycles)
+{
+	return cycles * CLOCK64_NS_PER_CYCLE;
+}
+
+/*------------------------------------------------/
+ Name:				clock64_to_us
+ Description: cycles in microseconds, exact for
+ 	 	 	  cycles < 2^64 / 34 at 50MHz (342 years)
+ ------------------------------------------------*/
+
+static ALT_INLINE alt_u64 clock64_to_us(alt_u64 cycles)
+{
+	return fix_mulhi64(cycles, FIX_RECIP64(CLOCK64_CYCLES_PER_US));
+}
+
+#endif /* CLOCK64_H_ */
@@ -0,0 +1,83 @@
+#ifndef CYCLES_H_
+#define CYCLES_H_
+
+#include <alt_types.h>
+#include <system.h>
+#include "clock64.h"
+
+/*###################################################
+ 	 	 	 	 CYCLE COUNTER
+- cycles_now(): clock cycles as one 32-bit load of
+  the cycle_counter_0 core (ip/cycle_counter). No
+  snapshot to take, so no interrupt lock and no
+  call: in a hot loop the time is one ldwio
+- cycles_now64(): all 64 bits, COUNT_HI is read
+  around COUNT until it is stable
+- CYCLES_USE_HW 0: timer_1 through alt_timestamp().
+  Its snapshot is shared with the ISRs, so it is
+  taken with interrupts off; cycles_now64() is then
+  clock64_now()
+- The count starts at reset (core) or at
+  clock64_init() (timer_1), only differences mean
+  anything
+###################################################*/
+
+#ifndef CYCLES_USE_HW
+#define CYCLES_USE_HW		1
+#endif
+
+#if CYCLES_USE_HW
+#include <cycle_counter_regs.h>
+
+#define CYCLES_BASE			CYCLE_COUNTER_0_BASE
+#define CYCLES_CLK			ALT_CPU_FREQ				// the core runs on the system clock
+#else
+#include <sys/alt_irq.h>
+#include <sys/alt_timestamp.h>
+
+#define CYCLES_CLK			TIMER_1_FREQ
+#endif
+
+/*------------------------------------------------/
+ Name:				cycles_now
+ Description: low 32 bits of the cycle count, safe
+ 	 	 	  in ISRs
+ ------------------------------------------------*/
+
+static ALT_INLINE alt_u32 cycles_now(void)
+{
+#if CYCLES_USE_HW
+	return IORD_CYCLE_COUNTER_COUNT(CYCLES_BASE);
+#else
+	alt_irq_context context = alt_irq_disable_all();
+	alt_u32 now = alt_timestamp();
+
+	alt_irq_enable_all(context);
+	return now;
+#endif
+}
+
+/*------------------------------------------------/
+ Name:				cycles_now64
+ Description: the whole cycle count. COUNT_HI
+ 	 	 	  changes once every 86s, so the loop
+ 	 	 	  almost never repeats
+ ------------------------------------------------*/
+
+static ALT_INLINE alt_u64 cycles_now64(void)
+{
+#if CYCLES_USE_HW
+	alt_u32 hi, lo, again = IORD_CYCLE_COUNTER_COUNT_HI(CYCLES_BASE);
+
+	do {
+		hi = again;
+		lo = IORD_CYCLE_COUNTER_COUNT(CYCLES_BASE);
+		again = IORD_CYCLE_COUNTER_COUNT_HI(CYCLES_BASE);
+	} while (again != hi);
+	return (alt_u64)hi << 32 | lo;
+#else
+	return clock64_now();
+#endif
+}
+
+#endif /* CYCLES_H_ */
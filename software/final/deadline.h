@@ -0,0 +1,86 @@
+#ifndef DEADLINE_H_
+#define DEADLINE_H_
+
+#include <alt_types.h>
+
+/*###################################################
+ 	 	 	 	 ABSOLUTE DEADLINES
+- A periodic deadline on a free-running 32-bit clock
+  (cycles_now() cycles, or alt_nticks()). The next
+  deadline is the previous one + period, never "now"
+  + period, so however late the check runs the
+  average rate stays exact
+- A check that comes more than a period late skips
+  the missed deadlines, keeps the phase and counts
+  them in overruns
+- Times are compared as signed differences, correct
+  across the 32-bit wrap while a check is less than
+  2^31 clocks late (43s at 50MHz)
+###################################################*/
+
+typedef struct {
+	alt_u32 next;							// absolute time of the next deadline
+	alt_u32 period;
+	alt_u32 overruns;						// deadlines skipped because a check was late
+} deadline_timer;
+
+/*------------------------------------------------/
+ Name:				deadline_start
+ Description: first deadline delay clocks from now.
+ 	 	 	  deadline_advance() needs a period > 0
+ ------------------------------------------------*/
+
+static ALT_INLINE void deadline_start(deadline_timer* d, alt_u32 now, alt_u32 delay, alt_u32 period)
+{
+	d->next = now + delay;
+	d->period = period;
+	d->overruns = 0;
+}
+
+/*------------------------------------------------/
+ Name:				deadline_left
+ Description: clocks until the next deadline,
+ 	 	 	  negative once it has passed
+ ------------------------------------------------*/
+
+static ALT_INLINE alt_32 deadline_left(const deadline_timer* d, alt_u32 now)
+{
+	return (alt_32)(d->next - now);
+}
+
+/*------------------------------------------------/
+ Name:				deadline_advance
+ Description: move on to the next deadline that has
+ 	 	 	  not passed; one that falls exactly on
+ 	 	 	  now is due, as in deadline_poll(), not
+ 	 	 	  skipped. Returns the number skipped
+ ------------------------------------------------*/
+
+static ALT_INLINE alt_u32 deadline_advance(deadline_timer* d, alt_u32 now)
+{
+	alt_u32 missed = 0;
+
+	d->next += d->period;
+	while (deadline_left(d, now) < 0) {
+		d->next += d->period;
+		missed++;
+	}
+	d->overruns += missed;
+	return missed;
+}
+
+/*------------------------------------------------/
+ Name:				deadline_poll
+ Description: 1 once per period: when the deadline
+ 	 	 	  has passed, advance it
+ ------------------------------------------------*/
+
+static ALT_INLINE int deadline_poll(deadline_timer* d, alt_u32 now)
+{
+	if (deadline_left(d, now) > 0) return 0;
+
+	deadline_advance(d, now);
+	return 1;
+}
+
+#endif /* DEADLINE_H_ */
@@ -0,0 +1,120 @@
+#include <stdio.h>
+#include "cycles.h"
+#include "fix_bench.h"
+#include "fixmath.h"
+
+#if FIX_BENCH
+
+/*------------------------------------------------/
+ Name:				variables
+ Description: every result goes to the sink, so
+ 	 	 	  no loop can be optimised away
+ ------------------------------------------------*/
+
+static volatile alt_u32 fix_bench_sink;
+static alt_u32 fix_bench_empty;					// cycles of the bare loop
+
+/*------------------------------------------------/
+ Name:				FIX_BENCH_TIME
+ Description: cycles for FIX_BENCH_CALLS values of
+ 	 	 	  expr, v stepping through [0, range).
+ 	 	 	  expr is expanded in the loop, so an
+ 	 	 	  inline kernel stays inline
+ ------------------------------------------------*/
+
+#define FIX_BENCH_TIME(cycles, range, expr)							\
+	do {															\
+		alt_u32 i_, v, t_;											\
+		t_ = cycles_now();											\
+		for (i_ = 0, v = 0; i_ < FIX_BENCH_CALLS;					\
+				i_++, v += (range) >> FIX_BENCH_SHIFT)				\
+			fix_bench_sink = (expr);								\
+		(cycles) = cycles_now() - t_;								\
+	} while (0)
+
+/*------------------------------------------------/
+ Name:				FIX_BENCH_CHECK
+ Description: inputs in [0, range) where the two
+ 	 	 	  expressions differ, every value
+ ------------------------------------------------*/
+
+#define FIX_BENCH_CHECK(bad, range, expr_new, expr_old)				\
+	do {															\
+		alt_u32 v;													\
+		for ((bad) = 0, v = 0; v < (range); v++)					\
+			if ((expr_new) != (expr_old)) (bad)++;					\
+	} while (0)
+
+/*------------------------------------------------/
+ Name:				fix_bench_dec
+ Description: old decimal split, one '/' and one
+ 	 	 	  '%' per digit, packed like fix_bcd()
+ ------------------------------------------------*/
+
+static alt_u32 fix_bench_dec(alt_u32 v)
+{
+	alt_u32 bcd = 0;
+	int i;
+
+	for (i = 0; i < 20; i += 4) {
+		bcd |= (v % 10) << i;
+		v /= 10;
+	}
+	return bcd;
+}
+
+/*------------------------------------------------/
+ Name:				fix_bench_line
+ Description: one row: cycles per call without the
+ 	 	 	  loop, old and new, and mismatches
+ ------------------------------------------------*/
+
+static void fix_bench_line(const char* name, alt_u32 old, alt_u32 new, alt_u32 bad)
+{
+	old = old > fix_bench_empty ? old - fix_bench_empty : 0;
+	new = new > fix_bench_empty ? new - fix_bench_empty : 0;
+	printf("%-12s %9lu %9lu %10lu\n", name,
+			(unsigned long)(old >> FIX_BENCH_SHIFT), (unsigned long)(new >> FIX_BENCH_SHIFT),
+			(unsigned long)bad);
+}
+
+/*------------------------------------------------/
+ Name:				fix_bench
+ Description: run every kernel and print the table
+ ------------------------------------------------*/
+
+void fix_bench(void)
+{
+	alt_u32 old, new, bad;
+
+	FIX_BENCH_TIME(fix_bench_empty, 81920, v);
+
+	printf("%-12s %9s %9s %10s\n", "kernel", "old cyc", "new cyc", "mismatches");
+
+	FIX_BENCH_TIME(old, 81920, v / 10);
+	FIX_BENCH_TIME(new, 81920, fix_div10(v));
+	FIX_BENCH_CHECK(bad, 81920, fix_div10(v), v / 10);
+	fix_bench_line("div10", old, new, bad);
+
+	FIX_BENCH_TIME(old, 81920, v % 10);
+	FIX_BENCH_TIME(new, 81920, v - fix_div10(v) * 10);
+	FIX_BENCH_CHECK(bad, 81920, v - fix_div10(v) * 10, v % 10);
+	fix_bench_line("mod10", old, new, bad);
+
+	FIX_BENCH_TIME(old, 43699, v / 100);
+	FIX_BENCH_TIME(new, 43699, fix_div100(v));
+	FIX_BENCH_CHECK(bad, 43699, fix_div100(v), v / 100);
+	fix_bench_line("div100", old, new, bad);
+
+	FIX_BENCH_TIME(old, 64000, v / 1000);
+	FIX_BENCH_TIME(new, 64000, fix_div1000(v));
+	FIX_BENCH_CHECK(bad, 64000, fix_div1000(v), v / 1000);
+	fix_bench_line("div1000", old, new, bad);
+
+	FIX_BENCH_TIME(old, 100000, fix_bench_dec(v));
+	FIX_BENCH_TIME(new, 100000, fix_bcd(v));
+	FIX_BENCH_CHECK(bad, 100000, fix_bcd(v), fix_bench_dec(v));
+	fix_bench_line("bcd 5 digit", old, new, bad);
+}
+
+#endif /* FIX_BENCH */
@@ -0,0 +1,39 @@
+#ifndef FIX_BENCH_H_
+#define FIX_BENCH_H_
+
+#include <alt_types.h>
+
+/*###################################################
+ 	 	 	 	 FIXED-POINT BENCHMARK
+- Times the fixmath.h kernels against the '/' and
+  '%' code they replaced, with cycles_now(), over
+  FIX_BENCH_CALLS inputs spread across each kernel's
+  exact range, and counts the results that differ
+- Printed once on the JTAG UART before the
+  scheduler starts:
+	make APP_CFLAGS_DEFINED_SYMBOLS=-DFIX_BENCH=1
+	nios2-terminal
+- The host simulator runs it too (SIM_CFLAGS=
+  "-DFIX_BENCH=1" ./build-sim), but only bus
+  accesses cost time there: the cycle columns are
+  meaningful on the board only, the mismatch column
+  everywhere
+- Built only with -DFIX_BENCH=1, otherwise
+  FIX_BENCH_RUN() is empty
+###################################################*/
+
+#ifndef FIX_BENCH
+#define FIX_BENCH			0
+#endif
+
+#define FIX_BENCH_SHIFT		10
+#define FIX_BENCH_CALLS		(1 << FIX_BENCH_SHIFT)	// per kernel
+
+#if FIX_BENCH
+void fix_bench(void);
+#define FIX_BENCH_RUN()		fix_bench()
+#else
+#define FIX_BENCH_RUN()
+#endif
+
+#endif /* FIX_BENCH_H_ */
@@ -0,0 +1,93 @@
+#include "fixmath.h"
+
+/*------------------------------------------------/
+ Name:				fix_mulhi64
+ Description: upper 64 bits of the 128-bit product,
+ 	 	 	  from four 32x32 products
+ ------------------------------------------------*/
+
+alt_u64 fix_mulhi64(alt_u64 a, alt_u64 b)
+{
+	alt_u32 a0 = a, a1 = a >> 32, b0 = b, b1 = b >> 32;
+	alt_u64 p00 = (alt_u64)a0 * b0, p01 = (alt_u64)a0 * b1, p10 = (alt_u64)a1 * b0;
+	alt_u64 mid = (p00 >> 32) + (alt_u32)p01 + (alt_u32)p10;
+
+	return (alt_u64)a1 * b1 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+}
+
+/*------------------------------------------------/
+ Name:				fix_bcd
+ Description: value as packed BCD, ones in bits
+ 	 	 	  3..0. Double dabble: before each shift
+ 	 	 	  every digit >= 5 gets 3 added, all eight
+ 	 	 	  at once. value must be < 100000000
+ ------------------------------------------------*/
+
+alt_u32 fix_bcd(alt_u32 value)
+{
+	alt_u32 bcd = 0, carry;
+	int i;
+
+	for (i = 31; i >= 0; i--) {
+		carry = (bcd + 0x33333333) & 0x88888888;	// digits that reach 8 with +3
+		bcd += (carry >> 2) | (carry >> 3);
+		bcd = bcd << 1 | (value >> i & 1);
+	}
+	return bcd;
+}
+
+/*------------------------------------------------/
+ Name:				fix_fmt_dec
+ Description: write value right-aligned in width
+ 	 	 	  characters, leading zeros as spaces,
+ 	 	 	  and terminate the string. buf must hold
+ 	 	 	  width+1 bytes. value must be < 65536,
+ 	 	 	  digits that do not fit are dropped
+ ------------------------------------------------*/
+
+void fix_fmt_dec(unsigned char buf[], alt_u32 value, int width)
+{
+	alt_u32 q;
+	int i;
+
+	buf[width] = 0;
+	for (i = width - 1; i >= 0; i--) {
+		if (value == 0 && i != width - 1) {
+			buf[i] = ' ';
+			continue;
+		}
+		q = fix_div10(value);
+		buf[i] = '0' + (value - q*10);
+		value = q;
+	}
+}
+
+/*------------------------------------------------/
+ Name:				fix_fmt_hz
+ Description: frequency in 6 characters plus the
+ 	 	 	  terminator, " 100Hz" below 1kHz,
+ 	 	 	  "1.5KHz" below 10kHz (rest dropped),
+ 	 	 	  " 20KHz" above. hz must be < 64000
+ ------------------------------------------------*/
+
+void fix_fmt_hz(unsigned char buf[], alt_u32 hz)
+{
+	alt_u32 q;
+
+	if (hz < 1000) {
+		fix_fmt_dec(buf, hz, 4);
+	} else if (hz < 10000) {
+		hz = fix_div100(hz);					// tenths of a kHz
+		q = fix_div10(hz);
+		buf[0] = '0' + q;
+		buf[1] = '.';
+		buf[2] = '0' + (hz - q*10);
+		buf[3] = 'K';
+	} else {
+		fix_fmt_dec(buf, fix_div1000(hz), 3);
+		buf[3] = 'K';
+	}
+	buf[4] = 'H';
+	buf[5] = 'z';
+	buf[6] = 0;
+}
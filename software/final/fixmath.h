@@ -0,0 +1,67 @@
+#ifndef FIXMATH_H_
+#define FIXMATH_H_
+
+#include <alt_types.h>
+
+/*###################################################
+ 	 	 	 	 FIXED-POINT MATH
+- The CPU has a hardware multiplier but no divider
+  (-mno-hw-div), every '/' by a variable or in a
+  loop is a libgcc __udivsi3 call
+- Division by a constant becomes a multiply by a
+  rounded-up reciprocal and a right shift. The
+  reciprocal is folded by the compiler
+- Only the low 32 bits of the product are used (no
+  mulx), so each kernel is exact for a limited range
+- fix_mulhi64() builds the high half of a 64x64
+  product from 32x32 products (libgcc multiplies,
+  no divide), for 64-bit counts
+###################################################*/
+
+/* ceil(2^s / d), evaluated at compile time when d and s are constants */
+#define FIX_RECIP(d, s)		((((alt_u32)1 << (s)) + (d) - 1) / (d))
+
+/* x / d, exact while x * FIX_RECIP(d, s) fits in 32 bits and the
+ * rounding error of the reciprocal stays below 1 (check the range) */
+#define FIX_DIV(x, d, s)	(((alt_u32)(x) * FIX_RECIP(d, s)) >> (s))
+
+/* ceil(2^64 / d) for d not a power of two, for fix_mulhi64(): x / d is
+ * exact while x * (FIX_RECIP64(d) * d - 2^64) < 2^64 */
+#define FIX_RECIP64(d)		(~(alt_u64)0 / (d) + 1)
+
+/*------------------------------------------------/
+ Name:				fix_div10
+ Description: x / 10, exact for x < 81920
+ ------------------------------------------------*/
+
+static ALT_INLINE alt_u32 fix_div10(alt_u32 x)
+{
+	return FIX_DIV(x, 10, 19);
+}
+
+/*------------------------------------------------/
+ Name:				fix_div100
+ Description: x / 100, exact for x < 43699
+ ------------------------------------------------*/
+
+static ALT_INLINE alt_u32 fix_div100(alt_u32 x)
+{
+	return FIX_DIV(x, 100, 19);
+}
+
+/*------------------------------------------------/
+ Name:				fix_div1000
+ Description: x / 1000, exact for x < 64000
+ ------------------------------------------------*/
+
+static ALT_INLINE alt_u32 fix_div1000(alt_u32 x)
+{
+	return FIX_DIV(x, 1000, 26);
+}
+
+alt_u64 fix_mulhi64(alt_u64 a, alt_u64 b);
+alt_u32 fix_bcd(alt_u32 value);
+void fix_fmt_dec(unsigned char buf[], alt_u32 value, int width);
+void fix_fmt_hz(unsigned char buf[], alt_u32 hz);
+
+#endif /* FIXMATH_H_ */
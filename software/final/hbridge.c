@@ -0,0 +1,169 @@
+#include <stddef.h>
+#include <sys/alt_alarm.h>
+#include <sys/alt_irq.h>
+#include <system.h>
+#include "fixmath.h"
+#include "hbridge.h"
+#include "pwm.h"
+
+/*------------------------------------------------/
+ Name:				variables
+ Description: per channel: the mode on the pins,
+ 	 	 	  the direction last driven, the tick it
+ 	 	 	  was asked to stop and the ticks from
+ 	 	 	  then to the end of the dead-time, and
+ 	 	 	  while a dead-time alarm runs, the
+ 	 	 	  direction it will switch to
+ ------------------------------------------------*/
+
+typedef struct {
+	hbridge_mode mode;
+	hbridge_mode driven;							// FORWARD, REVERSE or COAST (never driven)
+	alt_u32 stopped;								// alt_nticks() when mode left driven
+	alt_u32 deadtime;								// ticks after stopped
+	hbridge_mode pending;
+	alt_u32 waiting;
+	alt_alarm alarm;
+} hbridge_channel;
+
+static hbridge_channel hbridge[PWM_CHANNELS];
+
+/*------------------------------------------------/
+ Name:				hbridge_apply
+ Description: IN1/IN2 patterns of a mode for the
+ 	 	 	  HIGH and LOW phase of the channel
+ ------------------------------------------------*/
+
+static void hbridge_apply(alt_u32 ch, hbridge_mode mode)
+{
+	alt_u32 in1 = 1 << (2 * ch);
+	alt_u32 in2 = in1 << 1;
+
+	switch (mode) {
+	case HBRIDGE_FORWARD: pwm_set_pins(ch, in1, 0); break;
+	case HBRIDGE_REVERSE: pwm_set_pins(ch, in2, 0); break;
+	case HBRIDGE_BRAKE:   pwm_set_pins(ch, in1 | in2, in1 | in2); break;
+	default:              pwm_set_pins(ch, 0, 0); break;
+	}
+}
+
+/*------------------------------------------------/
+ Name:				hbridge_deadtime
+ Description: ticks from a stop request to the end
+ 	 	 	  of the dead-time. The undriven pattern
+ 	 	 	  only latches at the next period edge,
+ 	 	 	  up to one PWM period later, so that
+ 	 	 	  period is waited out first (rounded up,
+ 	 	 	  at most one tick long)
+ ------------------------------------------------*/
+
+static alt_u32 hbridge_deadtime(void)
+{
+	return HBRIDGE_DEADTIME_TICKS + FIX_DIV(pwm_get_period(), HBRIDGE_TICK_CLOCKS, 26) + 1;
+}
+
+/*------------------------------------------------/
+ Name:				hbridge_drive
+ Description: put a mode on the pins and keep track
+ 	 	 	  of the direction and when it stopped
+ ------------------------------------------------*/
+
+static void hbridge_drive(hbridge_channel* c, hbridge_mode mode)
+{
+	if (mode == HBRIDGE_FORWARD || mode == HBRIDGE_REVERSE)
+		c->driven = mode;
+	else if (c->mode == c->driven) {
+		c->stopped = alt_nticks();
+		c->deadtime = hbridge_deadtime();
+	}
+	c->mode = mode;
+	hbridge_apply(c - hbridge, mode);
+}
+
+/*------------------------------------------------/
+ Name:				hbridge_deadtime_end
+ Description: alarm callback: the channel has not
+ 	 	 	  been driven for HBRIDGE_DEADTIME_MS,
+ 	 	 	  drive the new direction
+ ------------------------------------------------*/
+
+static alt_u32 hbridge_deadtime_end(void* context)
+{
+	hbridge_channel* c = context;
+
+	c->waiting = 0;
+	hbridge_drive(c, c->pending);
+	return 0;
+}
+
+/*------------------------------------------------/
+ Name:				hbridge_init
+ Description: all channels coast, call after
+ 	 	 	  pwm_init()
+ ------------------------------------------------*/
+
+void hbridge_init(void)
+{
+	alt_u32 ch;
+
+	for (ch = 0; ch < PWM_CHANNELS; ch++) {
+		if (hbridge[ch].waiting) alt_alarm_stop(&hbridge[ch].alarm);
+		hbridge[ch].waiting = 0;
+		hbridge[ch].mode = HBRIDGE_COAST;
+		hbridge[ch].driven = HBRIDGE_COAST;
+		hbridge_apply(ch, HBRIDGE_COAST);
+	}
+}
+
+/*------------------------------------------------/
+ Name:				hbridge_set
+ Description: new mode for a channel, takes effect
+ 	 	 	  on the next period edge. The direction
+ 	 	 	  opposite to the one last driven waits
+ 	 	 	  until the channel has not been driven
+ 	 	 	  for HBRIDGE_DEADTIME_MS, whatever
+ 	 	 	  COAST or BRAKE came in between (they
+ 	 	 	  apply at once and keep the channel
+ 	 	 	  undriven while it waits)
+ ------------------------------------------------*/
+
+void hbridge_set(alt_u32 ch, hbridge_mode mode)
+{
+	hbridge_channel* c = &hbridge[ch];
+	alt_irq_context context;
+	alt_u32 idle;
+
+	context = alt_irq_disable_all();
+	if (mode == c->driven || mode == HBRIDGE_COAST || mode == HBRIDGE_BRAKE ||
+		c->driven == HBRIDGE_COAST) {
+		if (c->waiting) {							// reversal no longer wanted
+			alt_alarm_stop(&c->alarm);
+			c->waiting = 0;
+		}
+		if (mode != c->mode) hbridge_drive(c, mode);
+	} else {										// opposite of the last direction
+		c->pending = mode;
+		if (!c->waiting) {
+			if (c->mode == c->driven) hbridge_drive(c, HBRIDGE_COAST);
+			idle = alt_nticks() - c->stopped;
+			if (idle >= c->deadtime) {
+				hbridge_drive(c, mode);
+			} else {
+				c->waiting = 1;
+				alt_alarm_start(&c->alarm, c->deadtime - idle, hbridge_deadtime_end, c);
+			}
+		}
+	}
+	alt_irq_enable_all(context);
+}
+
+/*------------------------------------------------/
+ Name:				hbridge_get
+ Description: the mode last asked for (it may
+ 	 	 	  still be waiting for the dead-time)
+ ------------------------------------------------*/
+
+hbridge_mode hbridge_get(alt_u32 ch)
+{
+	return hbridge[ch].waiting ? hbridge[ch].pending : hbridge[ch].mode;
+}
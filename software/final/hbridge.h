@@ -0,0 +1,45 @@
+#ifndef HBRIDGE_H_
+#define HBRIDGE_H_
+
+#include <alt_types.h>
+#include <system.h>
+#include "pwm.h"
+
+/*###################################################
+ 	 	 	 	 	 H-BRIDGE OUTPUT
+- MOTOR bits 0..3 = L298 IN1..IN4 (mini.v), channel
+  A on IN1/IN2, channel B on IN3/IN4, ENA/ENB
+  jumpered high. Each channel is one PWM channel
+- FORWARD: IN1 = PWM, IN2 low    (sign-magnitude,
+  REVERSE: IN1 low, IN2 = PWM     LOW phase = coast)
+  BRAKE:   both high, motor terminals shorted
+  COAST:   both low
+- Forward <-> reverse goes through COAST for
+  HBRIDGE_DEADTIME_TICKS so the winding current has
+  decayed before the bridge is driven the other way.
+  The time counts from when the old direction was
+  asked to stop plus one PWM period, in which the
+  undriven pattern latches at a period edge, so
+  COAST or BRAKE in between only shortens the wait
+  by the time they were held
+###################################################*/
+
+#define HBRIDGE_A				0
+#define HBRIDGE_B				1
+
+#define HBRIDGE_DEADTIME_MS		5			// coast between direction changes
+#define HBRIDGE_DEADTIME_TICKS	(HBRIDGE_DEADTIME_MS + 1)	// system clock ticks, +1 for the partial first tick
+#define HBRIDGE_TICK_CLOCKS		(PWM_TIMER_FREQ / 1000)		// PWM clocks per system clock tick (1 ms)
+
+typedef enum {
+	HBRIDGE_COAST,
+	HBRIDGE_FORWARD,
+	HBRIDGE_REVERSE,
+	HBRIDGE_BRAKE
+} hbridge_mode;
+
+void         hbridge_init(void);
+void         hbridge_set(alt_u32 ch, hbridge_mode mode);
+hbridge_mode hbridge_get(alt_u32 ch);
+
+#endif /* HBRIDGE_H_ */
@@ -5,6 +5,17 @@
 #include <system.h>
 #include <string.h>
 #include <unistd.h>
+#include "clock64.h"
+#include "fix_bench.h"
+#include "fixmath.h"
+#include "hbridge.h"
+#include "hexdisp.h"
+#include "lcd.h"
+#include "prof.h"
+#include "pwm.h"
+#include "sched.h"
+#include "speed.h"
+#include "switch.h"
 /*#######################################################################
 							//Mini Project//
 - Build a system using Nios II in kit DE10 to connect a LCD 16x2 and an
@@ -17,282 +28,267 @@ H-bridge to control a motor. This system can do the following tasks:
  + When SW0 and SW1 are OFF, turn off the system.
 - EXTENSION:
   + SW1, SW2, SW3 will control the speed of the DC motor based on the PWM
-    Pulses be created by DE-10 kit nano.
+    Pulses be created by DE-10 kit nano. The LCD shows the speed set point
+    (SP, % of SPEED_MAX_RPM), the controller picks the duty cycle.
+  + SW4 moves the PWM frequency above the audible range (PWM_QUIET_FREQ),
+    the LCD shows the frequency actually set.
+  + SW5 replaces the frequency/duty text with a bar of the live motor speed
+    (16 cells, 80 levels, CGRAM glyphs).
+  + HEX5..HEX0 show live values at 50Hz, SW7..SW6 pick one: 00 output duty
+    cycle (d, %), 01 PWM frequency (F, Hz), 1x main loop rate (L, 1000 loops/s).
+  + LEDR9..LEDR0 are a CPU load bar, one LED per 10% of the last 100ms
+    (sched_load()).
 - FILE: miniProject
 #######################################################################*/
 
-/*###################################################
- 	 	 	 	 LCD 1602
-- Bits: 11
-- Order: RS  RW  E  D7  D6  D5  D4  D3  D2  D1  D0
-- 3 bit control (RS RW E):
-	+ 001: send command
-	+ 101: send data
-	+ EN (1->0): data was sent to LCD
-###################################################*/
-
 /*------------------------------------------------/
- Name:				lcd_write
- Description: support lcd_cmd and lcd_data to
- 	 	 	  send data to LCD controller
+ Name:				variables
+ Description: declare variables for using timer
  ------------------------------------------------*/
+#define PWM_QUIET_FREQ	20000				// Hz with SW4 ON, PWM_FREQ with SW4 OFF
 
-void lcd_write(int data)
-{
-	IOWR_ALTERA_AVALON_PIO_DATA(LCD_BASE, data | 0b00100000000);	// write data and command
-	myusleep();
-	IOWR_ALTERA_AVALON_PIO_DATA(LCD_BASE, data & 0b11011111111);	// just set bit EN (1->0) to recognize data sent
-	myusleep();
-}
+/* live speed in bar levels, rpm * LCD_BAR_LEVELS / SPEED_MAX_RPM = rpm * 2 / 75 */
+#if LCD_BAR_LEVELS * 75 != SPEED_MAX_RPM * 2
+#error "BAR_LEVEL() needs a new fraction"
+#endif
+#define BAR_LEVEL(rpm)	FIX_DIV((rpm) * 2, 75, 22)	// exact below 29500 rpm
 
-/*------------------------------------------------/
- Name:				lcd_cmd
- Description: send command to LCD controller
- ------------------------------------------------*/
+#define HEX_HZ			50					// seven-segment readout rate
 
-void lcd_cmd(char cmd)
-{
-	lcd_write(0b00100000000 + cmd);
-}
+/* loop passes in one readout period to 1000 loops/s, passes * HEX_HZ / 1000 = passes / 20
+ * = (passes / 4) / 5, exact below 327680 passes (16.3M loops/s) */
+#if 1000 / HEX_HZ != 20 || 1000 % HEX_HZ
+#error "HEX_LOOP_K() needs a new fraction"
+#endif
+#define HEX_LOOP_K(passes)	FIX_DIV((passes) >> 2, 5, 18)
+
+unsigned long LCD_state=1;
+unsigned long loops, loops_shown;			// main loop passes, count at the last readout
+unsigned long DC;
+unsigned long SW;							// debounced switch state
+switch_event SW_event;
+
+sched_task task_speed, task_switch, task_motor, task_blink, task_refresh, task_lcd, task_hex, task_load, task_report;
 
 /*------------------------------------------------/
- Name:				lcd_data
- Description: send data to LCD controller
+ Name:				string char
+ Description: declare strings printing on LCD
  ------------------------------------------------*/
 
-void lcd_data(char data)
-{
-	lcd_write(0b10100000000 + data);
-}
+unsigned char hello[]  = "Hello World !!!";
+unsigned char empty[] = "                ";
+unsigned char paraPWM[] = "f:       SP:   %";
 
 /*------------------------------------------------/
- Name:				lcd_init
- Description: Initialize LCD before showing text
+ Name:				displacy_PWM
+ Description: display the PWM frequency and the
+ 	 	 	  speed set point (SP, % of SPEED_MAX_RPM)
+ 	 	 	  on LCD. The duty cycle the controller
+ 	 	 	  outputs is on HEX 'd' (with SW5 ON
+ 	 	 	  run_refresh() draws the speed bar)
  ------------------------------------------------*/
 
-void lcd_init()
+void display_PWM()
 {
-	lcd_write(0b00100111000);	// Set 2 line on LCD
-
-	lcd_write(0b00100001100);	// Display On/Off control
+	unsigned char field[7];
 
-	lcd_write(0b00100000110);   // Entry mode set
+	if (((SW >> 5) & 1) == 1) return;
 
-	lcd_write(0b00100000001);   // Clear screen
-}
+	PROF_ENTER(PROF_DISPLAY);
+	lcd_fb_puts(1,0,paraPWM);
+	fix_fmt_hz(field, pwm_get_freq());	// " 100Hz", "1.5KHz", " 20KHz"
+	lcd_fb_puts(1,2,field);
+	fix_fmt_dec(field, DC, 3);		// set point "  0".."100", no division
+	lcd_fb_puts(1,12,field);
+	PROF_EXIT(PROF_DISPLAY);
+	}
 
-/*------------------------------------------------/
- Name:				lcd_printtext
- Description: print text or string on the screen
- ------------------------------------------------*/
+/*----------------------------------------------------------------------------------------------/
+Operation: 						  			SWITCH 0 IS ON
+Description: LCD blinks the sentence Hello World !!! in the middle of row 1 with frequency 1Hz.
+			 Runs every 0.5s, woken at once when SW0 changes
+----------------------------------------------------------------------------------------------*/
 
-void lcd_printtext(unsigned char string[])
+void run_blink(void)
 {
-	for (int i = 0; i < strlen(string); i++)
-		lcd_data(string[i]);
+	if ((SW&1)== 0X01)
+	{
+		if (LCD_state == 0) lcd_fb_puts(0,1,empty);
+		else                lcd_fb_puts(0,1,hello);		// Print "Hello World!!!"
+		LCD_state = !LCD_state;
+	}
+	else
+	{
+		LCD_state = 1;
+		lcd_fb_puts(0,1,empty);	    // Clear 1st line if SW0 is OFF
+	}
 }
 
-/*------------------------------------------------/
- Name:				lcd_setcursor
- Description: set cursor position on display
- ------------------------------------------------*/
+/*----------------------------------------------------------------------------------------------/
+Operation: 						SWITCH 1 OR SWITCH 2 OR SWITCH 3 IS ON
+Description: Run the DC motor at 50%, 100% or 25% of SPEED_MAX_RPM (closed loop, speed.c).
+			 Only runs when run_switch() saw SW1..SW5 change
+----------------------------------------------------------------------------------------------*/
 
-void lcd_setcursor(char row, char col)
+void run_motor(void)
 {
-	int row_char = 0;
-	if (row == 1) row_char = 64;
-	lcd_cmd(0b00010000000 + row_char + col);
-}
+	PROF_ENTER(PROF_SWITCH);
+	pwm_set_freq(((SW >> 4) & 1) ? PWM_QUIET_FREQ : PWM_FREQ);	// new period from the next PWM edge on
 
-/*------------------------------------------------/
- Name:				variables
- Description: declare variables for using timer
- ------------------------------------------------*/
-unsigned long LCD_state=1, LCD_mark;
-unsigned long HIGH, LOW, wait_time, wait;
-unsigned long now, PWM_mark, PWM_state;
-unsigned long DC;
-
-/*------------------------------------------------/
- Name:				string char
- Description: declare strings printing on LCD
- ------------------------------------------------*/
-
-unsigned char hello[]  = "Hello World !!!";
-unsigned char empty[] = "                ";
-unsigned char paraPWM[] = "f: 1KHz DC:    %";
+	if (((SW >> 1) & 1) == 1)
+	{
+		DC = 50;
+		speed_set(DC);
+		display_PWM();
+	}
+	else if (((SW >> 2) & 1) == 1)
+	{
+		DC = 100;
+		speed_set(DC);
+		display_PWM();
+	}
+	else if (((SW >> 3) & 1) == 1)
+	{
+		DC = 25;
+		speed_set(DC);
+		display_PWM();
+	}
+	else
+	{
+		DC = 0;
+		speed_set(0);
+		lcd_fb_puts(1,0,empty);		// Clear 2nd line if SW(1||2||3) is OFF
+	}
+	PROF_EXIT(PROF_SWITCH);
+}
 
 /*------------------------------------------------/
- Name:				myusleep
- Description: set delay time without affecting
- 			  other operations
+ Name:				run_switch
+ Description: take the debounced switch events and
+ 	 	 	  wake the tasks they concern
  ------------------------------------------------*/
 
-void myusleep()
+void run_switch(void)
 {
-	wait = alt_timestamp();
-	while (alt_timestamp() - wait < 5000) create_PWM();
+	while (switch_get(&SW_event))			// only runs when a switch changed
+	{
+		SW = SW_event.state;
+		if (SW_event.changed & 0x01)
+		{
+			LCD_state = 1;					// start blinking with the text shown
+			sched_wake(&task_blink, 0);
+		}
+		if (SW_event.changed & 0x3E) sched_wake(&task_motor, 0);
+	}
 }
 
-/*###################################################
- 	 	 	 	 PWM
-###################################################*/
-
 /*------------------------------------------------/
- Name:				update_PWM
- Description: Update on time and off time for PWM
- 	 	 	  pulse depending on duty cycle change
+ Name:				run_refresh, run_lcd
+ Description: send what changed in the framebuffer
+ 	 	 	  at 20Hz, after updating the speed bar
+ 	 	 	  if it is shown; run_lcd strobes the queued
+ 	 	 	  bytes out and wakes itself when the
+ 	 	 	  LCD can take the next one, until the
+ 	 	 	  queue is empty
  ------------------------------------------------*/
 
-void update_PWM()
+void run_refresh(void)
 {
-/* Using DE-10 kit with frequency 50MHz --> 1 clock cycle corresponds 20 nanosecond
- * So, when applying required frequency 1kHz --> 1 required clock cycle corresponds 1 millisecond
- * --> 1 millisecond of 1 required clock cycle corresponds 50000 clock cycle on DE-10 kit
- * --> From above, the number of clock cycle using for duty cycle be determined. */
-	HIGH = 50000*DC/100;
-	LOW = 50000 - HIGH;
-}
+	if (DC && ((SW >> 5) & 1) == 1) lcd_fb_bar(1, BAR_LEVEL(speed_rpm()));
 
-/*------------------------------------------------/
- Name:				pwm_init
- Description: Initialize the default values and set
- 	 	 	  the time start & time control for PWM
- ------------------------------------------------*/
+	PROF_ENTER(PROF_LCD_FLUSH);
+	lcd_fb_flush();				// send only what changed
+	PROF_EXIT(PROF_LCD_FLUSH);
+	if (!lcd_idle()) sched_wake(&task_lcd, 0);
+}
 
-void pwm_init()
+void run_lcd(void)
 {
-	DC = 50;
-	update_PWM();
-	PWM_state = 0;
-	wait_time = LOW;
-	alt_timestamp_start();
-	PWM_mark = alt_timestamp();
-	LCD_mark = alt_timestamp();
+	alt_u32 wait;
+
+	PROF_ENTER(PROF_LCD_SERVICE);
+	wait = lcd_service();		// until the controller can take the next byte
+	PROF_EXIT(PROF_LCD_SERVICE);
+	if (!lcd_idle()) sched_wake(&task_lcd, wait);
 }
 
 /*------------------------------------------------/
- Name:				create_PWM
- Description: create PWM pulse to L298_H_bridge
+ Name:				run_hex
+ Description: one value on HEX5..HEX0, chosen by
+ 	 	 	  SW7..SW6. The loop rate comes from the
+ 	 	 	  passes since the last readout
  ------------------------------------------------*/
 
-void create_PWM()
+void run_hex(void)
 {
-	  now = alt_timestamp();
-	  if (now - PWM_mark  >= wait_time)
-	  {
-		  PWM_state = !PWM_state;
-
-	  if (PWM_state == 0) wait_time = LOW;
-	  else                wait_time = HIGH;
+	alt_u32 passes = loops - loops_shown;
 
-		  PWM_mark = alt_timestamp();
-	  }
+	loops_shown = loops;
+	switch ((SW >> 6) & 3)
+	{
+	case 0:										// duty driven now, not the set point
+		hexdisp_show(HEXDISP_LABEL_D, (speed_duty16() * 100 + PWM_DUTY16_FULL / 2) >> 16);
+		break;
+	case 1:
+		hexdisp_show(HEXDISP_LABEL_F, pwm_get_freq());
+		break;
+	default:
+		hexdisp_show(HEXDISP_LABEL_L, HEX_LOOP_K(passes));
+		break;
+	}
 }
 
 /*------------------------------------------------/
- Name:				displacy_PWM
- Description: display frequency and duty cycle
- 	 	 	  controlling the motor on LCD
+ Name:				run_load
+ Description: CPU load bar on LEDR, rounded to the
+ 	 	 	  nearest 10%, after every load window
  ------------------------------------------------*/
 
-void display_PWM()
+void run_load(void)
 {
-	lcd_setcursor(1,0);
-	lcd_printtext(paraPWM);
-	lcd_setcursor(1,12);
-
-	unsigned long num = DC;
-
-	unsigned long a = num/100;			// Split to find and print hundreds
-		if (a==0) lcd_printtext(" ");
-		else lcd_data(a + 0x30);
-		lcd_setcursor(1,13);
-		num = num - a*100;				    // Update number to find and print next
-		a = num/10;							// Split to find and print tens
-		lcd_data(a+0x30);
-		num = num - a*10;					// Update number to find and print next
-		a = num/1;							// Split to find and print units
-		lcd_data(a+0x30);
-	}
+	alt_u32 leds = fix_div100(sched_load() + 50);		// 0..10
+
+	IOWR_ALTERA_AVALON_PIO_DATA(LED_BASE, (1 << leds) - 1);
+}
 
 	/*------------------------------------------------/
 	 Name:				MAIN PROGRAM
+	 Description: the loop only dispatches tasks,
+	 	 	 	  earliest deadline first (sched.c)
 	 ------------------------------------------------*/
 
 	int main()
 	{
+		  clock64_init();						// timer_1, also alt_timestamp()
 		  pwm_init();
+		  hbridge_init();
+		  speed_init();
 		  lcd_init();
-
-		  while(1){
-
-	/*----------------------------------------------------------------------------------------------/
-	Operation: 						  			SWITCH 0 IS ON
-	Description: LCD blinks the sentence Hello World !!! in the middle of row 1 with frequency 1Hz
-	----------------------------------------------------------------------------------------------*/
-		  now = alt_timestamp();
-		  if ((IORD_ALTERA_AVALON_PIO_DATA(SWITCH_BASE)&1)== 0X01)
-		  {
-			  lcd_setcursor(0,1);
-			  lcd_printtext(hello);		// Print "Hello World!!!"
-
-			  /*-------------------------------------------------*/
-				if (now - LCD_mark >= 25000000) {
-			    	if (LCD_state == 0) {
-			    		lcd_setcursor(0,1);
-			    		lcd_printtext(empty);
-			    	} else {
-			    		lcd_setcursor(0,1);
-			    		lcd_printtext(hello);
-			    	}
-					LCD_state = !LCD_state;
-					LCD_mark = alt_timestamp(); // Save current timestamp right after toggling the state.
-		  }
-		  else
-		  {
-			  LCD_state = 1;
-			  lcd_setcursor(0,1);
-			  lcd_printtext(empty);	    // Clear 1st line if SW0 is OFF
-		  }
+		  switch_init();
+		  hexdisp_init();
+		  PROF_INIT();
+		  FIX_BENCH_RUN();						// -DFIX_BENCH=1 only
+
+		  sched_init();
+		  sched_add(&task_speed,   "speed",   speed_step,  SPEED_CTRL_CYCLES, 0);	// PI step at 1kHz
+		  sched_add(&task_lcd,     "lcd",     run_lcd,     0, LCD_EXEC_TICKS);
+		  sched_add(&task_switch,  "switch",  run_switch,  SCHED_HZ(200), 0);
+		  sched_add(&task_motor,   "motor",   run_motor,   0, SCHED_HZ(200));
+		  sched_add(&task_refresh, "refresh", run_refresh, SCHED_HZ(20), 0);
+		  sched_add(&task_blink,   "blink",   run_blink,   SCHED_HZ(2), 0);		// toggle twice per blink
+		  sched_add(&task_hex,     "hex",     run_hex,     SCHED_HZ(HEX_HZ), 0);
+		  sched_add(&task_load,    "load",    run_load,    SCHED_LOAD_WINDOW, 0);
+		  if (SCHED_REPORT) {
+			  sched_add(&task_report, "report", sched_report, SCHED_REPORT_PERIOD, 0);
+			  sched_wake(&task_report, SCHED_REPORT_PERIOD);	// first table after 5s
 		  }
+		  sched_wake(&task_lcd, 0);				// lcd_init() queued the set-up commands
 
-	/*----------------------------------------------------------------------------------------------/
-	Operation: 						SWITCH 1 OR SWITCH 2 OR SWITCH 3 IS ON
-	Description: Create PWM pulses to control DC motor based on duty cycle with  100%, 50% and 25%
-	----------------------------------------------------------------------------------------------*/
-
-		  if (((IORD_ALTERA_AVALON_PIO_DATA(SWITCH_BASE) >> 1) & 1) == 1)
-		  {
-			  DC = 50;
-			  update_PWM();
-			  create_PWM();
-			  IOWR_ALTERA_AVALON_PIO_DATA(MOTOR_BASE, PWM_state);
-			  display_PWM();
-		  }
-		  else if (((IORD_ALTERA_AVALON_PIO_DATA(SWITCH_BASE) >> 2) & 1) == 1)
-		  {
-			  DC = 100;
-			  update_PWM();
-			  create_PWM();
-			  IOWR_ALTERA_AVALON_PIO_DATA(MOTOR_BASE, PWM_state);
-			  display_PWM();
-		  }
-		  else if (((IORD_ALTERA_AVALON_PIO_DATA(SWITCH_BASE) >> 3) & 1) == 1)
-		  {
-			  DC = 25;
-			  update_PWM();
-			  create_PWM();
-			  IOWR_ALTERA_AVALON_PIO_DATA(MOTOR_BASE, PWM_state);
-			  display_PWM();
-		  }
-		  else
-		  {
-			  IOWR_ALTERA_AVALON_PIO_DATA(MOTOR_BASE, 0);
-			  lcd_setcursor(1,0);
-			  lcd_printtext(empty);		// Clear 1st line if SW(1||2||3) is OFF
-		  }
+		  while(1){
+		  PROF_POLL();
+		  PROF_ENTER(PROF_LOOP);
+		  loops++;
+		  sched_run();
+		  PROF_EXIT(PROF_LOOP);
 	  }
 	}
-
-
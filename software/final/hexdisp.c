@@ -0,0 +1,56 @@
+#include <hex_display_regs.h>
+#include <system.h>
+#include "fixmath.h"
+#include "hexdisp.h"
+
+/*------------------------------------------------/
+ Name:				variables
+ Description: last label and CONTROL written, to
+ 	 	 	  leave out stores that change nothing
+ ------------------------------------------------*/
+
+static alt_u32 hexdisp_label, hexdisp_control;
+
+/*------------------------------------------------/
+ Name:				hexdisp_init
+ Description: all displays dark, HEX5 shows its
+ 	 	 	  raw segments from now on
+ ------------------------------------------------*/
+
+void hexdisp_init(void)
+{
+	hexdisp_label = HEXDISP_LABEL_NONE;
+	hexdisp_control = HEX_DISPLAY_CONTROL_BLANK_MSK | 1 << 5;
+	IOWR_HEX_DISPLAY_SEG_HI(HEXDISP_BASE, 0);
+	IOWR_HEX_DISPLAY_CONTROL(HEXDISP_BASE, hexdisp_control);
+}
+
+/*------------------------------------------------/
+ Name:				hexdisp_show
+ Description: label on HEX5, value on HEX4..HEX0.
+ 	 	 	  Digits left of the first non-zero one
+ 	 	 	  are blanked, a zero shows one 0
+ ------------------------------------------------*/
+
+void hexdisp_show(alt_u32 label, alt_u32 value)
+{
+	alt_u32 bcd, control, n;
+
+	if (value > HEXDISP_MAX) value = HEXDISP_MAX;
+	bcd = fix_bcd(value);
+
+	control = 1 << 5;							// HEX5: raw label
+	if (label == HEXDISP_LABEL_NONE) control |= 1 << (HEX_DISPLAY_CONTROL_BLANK_OFST + 5);
+	for (n = HEXDISP_DIGITS - 1; n > 0 && !(bcd >> HEX_DISPLAY_DIGIT_OFST(n) & 0xF); n--)
+		control |= 1 << (HEX_DISPLAY_CONTROL_BLANK_OFST + n);
+
+	IOWR_HEX_DISPLAY_DIGITS(HEXDISP_BASE, bcd);
+	if (label != hexdisp_label) {
+		hexdisp_label = label;
+		IOWR_HEX_DISPLAY_SEG_HI(HEXDISP_BASE, label << HEX_DISPLAY_SEG_OFST(5));
+	}
+	if (control != hexdisp_control) {
+		hexdisp_control = control;
+		IOWR_HEX_DISPLAY_CONTROL(HEXDISP_BASE, control);
+	}
+}
@@ -0,0 +1,32 @@
+#ifndef HEXDISP_H_
+#define HEXDISP_H_
+
+#include <alt_types.h>
+#include <system.h>
+
+/*###################################################
+ 	 	 	 	 SEVEN-SEGMENT READOUT
+- hex_display_0 core (ip/hex_display) on HEX0..HEX5
+- hexdisp_show(): a label on HEX5 (raw segments) and
+  a decimal value on HEX4..HEX0, leading zeros dark.
+  The value goes out as BCD in one DIGITS store; the
+  label and the blank mask are only stored when they
+  change, so an update is one or two stores and
+  never waits
+- Values above HEXDISP_MAX show as HEXDISP_MAX
+###################################################*/
+
+#define HEXDISP_BASE		HEX_DISPLAY_0_BASE
+#define HEXDISP_DIGITS		5					// HEX4..HEX0
+#define HEXDISP_MAX			99999
+
+/* labels: raw segments, bit 0 = a .. bit 6 = g */
+#define HEXDISP_LABEL_NONE	0x00
+#define HEXDISP_LABEL_D		0x5E				// d: output duty cycle
+#define HEXDISP_LABEL_F		0x71				// F: frequency
+#define HEXDISP_LABEL_L		0x38				// L: loop rate
+
+void hexdisp_init(void);
+void hexdisp_show(alt_u32 label, alt_u32 value);
+
+#endif /* HEXDISP_H_ */
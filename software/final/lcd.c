@@ -0,0 +1,506 @@
+#include <string.h>
+#include <altera_avalon_pio_regs.h>
+#include <system.h>
+#include "cycles.h"
+#include "lcd.h"
+
+#if LCD_USE_HW
+#include <lcd_refresh_regs.h>
+#endif
+
+/*------------------------------------------------/
+ Name:				framebuffer
+ Description: lcd_fb holds what should be on the
+ 	 	 	  panel, lcd_shown what has been queued
+ 	 	 	  to it. lcd_cursor is the DDRAM address
+ 	 	 	  the next data write goes to
+ ------------------------------------------------*/
+
+#define LCD_CURSOR_UNKNOWN	0xFFFFFFFF
+
+static unsigned char lcd_fb[LCD_ROWS][LCD_COLS];
+static unsigned char lcd_shown[LCD_ROWS][LCD_COLS];
+static alt_u32 lcd_cursor = LCD_CURSOR_UNKNOWN;
+
+/*------------------------------------------------/
+ Name:				glyphs
+ Description: lcd_cgram is what was last queued to
+ 	 	 	  each CGRAM slot, lcd_cgram_valid the
+ 	 	 	  slots that hold it (bit n = slot n)
+ ------------------------------------------------*/
+
+static alt_u8 lcd_cgram[LCD_GLYPHS][8];
+static alt_u32 lcd_cgram_valid;
+
+/* bar steps: 1..4 of the 5 pixel columns lit from the left */
+static const alt_u8 lcd_bar_glyph[LCD_CELL_COLS - 1][8] = {
+	{ 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10 },
+	{ 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18 },
+	{ 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C },
+	{ 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E }
+};
+
+#if LCD_USE_HW
+
+/*------------------------------------------------/
+ Name:				lcd_text_word
+ Description: store TEXT word n (cells 4n..4n+3,
+ 	 	 	  row 0 then row 1) if the framebuffer
+ 	 	 	  differs from what the core holds
+ ------------------------------------------------*/
+
+static void lcd_text_word(alt_u32 n)
+{
+	unsigned char* fb = &lcd_fb[0][0] + n * 4;
+	unsigned char* shown = &lcd_shown[0][0] + n * 4;
+
+	if (!memcmp(fb, shown, 4)) return;
+
+	IOWR_LCD_REFRESH_TEXT(LCD_CORE_BASE, n,
+			fb[0] | (alt_u32)fb[1] << 8 | (alt_u32)fb[2] << 16 | (alt_u32)fb[3] << 24);
+	memcpy(shown, fb, 4);
+}
+
+/*------------------------------------------------/
+ Name:				lcd_status
+ Description: no busy flag to read, the core
+ 	 	 	  waits by itself
+ ------------------------------------------------*/
+
+alt_u32 lcd_status(void)
+{
+	return 0;
+}
+
+/*------------------------------------------------/
+ Name:				lcd_service
+ Description: nothing queued, the core refreshes
+ 	 	 	  the panel
+ ------------------------------------------------*/
+
+alt_u32 lcd_service(void)
+{
+	return 0;
+}
+
+/*------------------------------------------------/
+ Name:				lcd_idle
+ Description: 1, every write went to the core
+ ------------------------------------------------*/
+
+int lcd_idle(void)
+{
+	return 1;
+}
+
+/*------------------------------------------------/
+ Name:				lcd_cmd
+ Description: clear display and set DDRAM address,
+ 	 	 	  the core does the rest of the set-up
+ ------------------------------------------------*/
+
+void lcd_cmd(char cmd)
+{
+	alt_u32 n;
+
+	if (cmd & 0x80) {
+		lcd_cursor = cmd & 0x7F;
+	} else if (cmd == 0x01) {
+		memset(lcd_fb, ' ', sizeof(lcd_fb));
+		for (n = 0; n < LCD_REFRESH_TEXT_WORDS; n++) lcd_text_word(n);
+		lcd_cursor = 0;
+	}
+}
+
+/*------------------------------------------------/
+ Name:				lcd_data
+ Description: one cell at the cursor, straight to
+ 	 	 	  the core
+ ------------------------------------------------*/
+
+void lcd_data(char data)
+{
+	alt_u32 row = lcd_cursor >> 6 & 1, col = lcd_cursor & 0x3F;
+
+	if (col < LCD_COLS) {
+		lcd_fb[row][col] = data;
+		lcd_text_word(row * LCD_COLS / 4 + col / 4);
+	}
+	lcd_cursor++;
+}
+
+/*------------------------------------------------/
+ Name:				lcd_init
+ Description: blank the core's framebuffer and
+ 	 	 	  start it, it initialises the panel
+ ------------------------------------------------*/
+
+void lcd_init(void)
+{
+	alt_u32 n;
+
+	memset(lcd_fb, ' ', sizeof(lcd_fb));
+	for (n = 0; n < LCD_REFRESH_TEXT_WORDS; n++)
+		IOWR_LCD_REFRESH_TEXT(LCD_CORE_BASE, n, 0x20202020);
+	memset(lcd_shown, ' ', sizeof(lcd_shown));
+	lcd_cursor = 0;
+	lcd_cgram_valid = 0;					// reload the core's CGRAM on first use
+	IOWR_LCD_REFRESH_CONTROL(LCD_CORE_BASE, LCD_REFRESH_CONTROL_RUN_MSK);
+}
+
+/*------------------------------------------------/
+ Name:				lcd_fb_flush
+ Description: store the TEXT words that changed,
+ 	 	 	  the core sends the changed cells
+ ------------------------------------------------*/
+
+void lcd_fb_flush(void)
+{
+	alt_u32 n;
+
+	for (n = 0; n < LCD_REFRESH_TEXT_WORDS; n++)
+		lcd_text_word(n);
+}
+
+/*------------------------------------------------/
+ Name:				lcd_glyph_set
+ Description: define CGRAM slot 0..7 (rows top to
+ 	 	 	  bottom, bit 4 = left pixel). Two CGRAM
+ 	 	 	  stores, only if the slot changed
+ ------------------------------------------------*/
+
+void lcd_glyph_set(alt_u32 slot, const alt_u8 rows[8])
+{
+	alt_u32 half, word;
+	int i;
+
+	if (slot >= LCD_GLYPHS) return;
+	if ((lcd_cgram_valid >> slot & 1) && !memcmp(lcd_cgram[slot], rows, 8)) return;
+
+	for (half = 0; half < 2; half++) {
+		for (word = 0, i = 3; i >= 0; i--)
+			word = word << 8 | (rows[half * 4 + i] & LCD_REFRESH_CGRAM_ROW_MSK);
+		IOWR_LCD_REFRESH_CGRAM(LCD_CORE_BASE, slot * 2 + half, word);
+	}
+	memcpy(lcd_cgram[slot], rows, 8);
+	lcd_cgram_valid |= 1 << slot;
+}
+
+#else /* !LCD_USE_HW */
+
+/*------------------------------------------------/
+ Name:				variables
+ Description: ring buffer of 11-bit LCD words (E
+ 	 	 	  cleared) and the time the controller
+ 	 	 	  stays busy after the last strobe
+ ------------------------------------------------*/
+
+static alt_u16 lcd_queue[LCD_QUEUE_SIZE];
+static alt_u32 lcd_head, lcd_tail;			// head: next free slot, tail: next word to send
+static alt_u32 lcd_mark, lcd_wait;
+static int lcd_bf_valid;					// BF is undefined before the first function set
+
+/*------------------------------------------------/
+ Name:				lcd_put
+ Description: queue one word. If the queue is full
+ 	 	 	  keep the LCD running until a slot is
+ 	 	 	  free
+ ------------------------------------------------*/
+
+static void lcd_put(alt_u32 word)
+{
+	while (lcd_head - lcd_tail >= LCD_QUEUE_SIZE) lcd_service();
+
+	lcd_queue[lcd_head & (LCD_QUEUE_SIZE - 1)] = word;
+	lcd_head++;
+}
+
+/*------------------------------------------------/
+ Name:				lcd_strobe
+ Description: E high for LCD_PW_EH_TICKS, RS, RW
+ 	 	 	  and data already set up (word). For a
+ 	 	 	  read, returns D7..D0 sampled before E
+ 	 	 	  falls. With outset/outclear each edge
+ 	 	 	  is one write of E alone
+ ------------------------------------------------*/
+
+static alt_u32 lcd_strobe(alt_u32 word)
+{
+	alt_u32 mark, data;
+
+#if LCD_BIT_MODIFYING_OUTPUT_REGISTER
+	IOWR_ALTERA_AVALON_PIO_SET_BITS(LCD_BASE, LCD_E);
+#else
+	IOWR_ALTERA_AVALON_PIO_DATA(LCD_BASE, word | LCD_E);
+#endif
+	mark = cycles_now();
+	while (cycles_now() - mark < LCD_PW_EH_TICKS);		// also covers tDDR (360ns)
+	data = IORD_ALTERA_AVALON_PIO_DATA(LCD_BASE) & 0xFF;
+#if LCD_BIT_MODIFYING_OUTPUT_REGISTER
+	IOWR_ALTERA_AVALON_PIO_CLEAR_BITS(LCD_BASE, LCD_E);		// EN (1->0): data was sent to LCD
+#else
+	IOWR_ALTERA_AVALON_PIO_DATA(LCD_BASE, word);			// EN (1->0): data was sent to LCD
+#endif
+	return data;
+}
+
+/*------------------------------------------------/
+ Name:				lcd_status
+ Description: read busy flag (LCD_BF) and address
+ 	 	 	  counter. D7..D0 are released while
+ 	 	 	  RW=1, lcd_service() drives them again
+ 	 	 	  before the next write. Only with
+ 	 	 	  LCD_BUSY_POLL, 0 otherwise
+ ------------------------------------------------*/
+
+alt_u32 lcd_status(void)
+{
+#if LCD_BUSY_POLL
+	IOWR_ALTERA_AVALON_PIO_DIRECTION(LCD_BASE, LCD_CTRL);
+	IOWR_ALTERA_AVALON_PIO_DATA(LCD_BASE, LCD_RW);
+	return lcd_strobe(LCD_RW);
+#else
+	return 0;
+#endif
+}
+
+/*------------------------------------------------/
+ Name:				lcd_service
+ Description: send the next queued word once the
+ 	 	 	  LCD controller has finished the last
+ 	 	 	  one. Returns the ticks after which it
+ 	 	 	  wants to be called again, 0 when the
+ 	 	 	  queue is empty
+ ------------------------------------------------*/
+
+alt_u32 lcd_service(void)
+{
+	alt_u32 word, waited;
+
+	if (lcd_head == lcd_tail) return 0;
+	waited = cycles_now() - lcd_mark;
+	if (waited < lcd_wait) return lcd_wait - waited;
+#if LCD_BUSY_POLL
+	if (lcd_bf_valid && (lcd_status() & LCD_BF)) return LCD_POLL_TICKS;
+	lcd_bf_valid = 1;
+#endif
+
+	word = lcd_queue[lcd_tail & (LCD_QUEUE_SIZE - 1)];
+	lcd_tail++;
+
+	IOWR_ALTERA_AVALON_PIO_DATA(LCD_BASE, word);			// RS, RW and data settle before E rises
+#if LCD_BUSY_POLL
+	IOWR_ALTERA_AVALON_PIO_DIRECTION(LCD_BASE, LCD_CTRL | 0xFF);
+#endif
+	lcd_strobe(word);
+
+	lcd_mark = cycles_now();
+	if (!(word & LCD_RS) && (word & 0xFF) <= 0x03)			// clear display / return home
+		lcd_wait = LCD_BUSY_POLL ? LCD_CLEAR_MIN_TICKS : LCD_CLEAR_TICKS;
+	else
+		lcd_wait = LCD_BUSY_POLL ? LCD_EXEC_MIN_TICKS : LCD_EXEC_TICKS;
+	return lcd_wait;
+}
+
+/*------------------------------------------------/
+ Name:				lcd_idle
+ Description: 1 when every queued word was sent
+ ------------------------------------------------*/
+
+int lcd_idle(void)
+{
+	return lcd_head == lcd_tail;
+}
+
+/*------------------------------------------------/
+ Name:				lcd_cmd
+ Description: send command to LCD controller
+ ------------------------------------------------*/
+
+void lcd_cmd(char cmd)
+{
+	lcd_put((alt_u8)cmd);
+	lcd_cursor = LCD_CURSOR_UNKNOWN;
+}
+
+/*------------------------------------------------/
+ Name:				lcd_data
+ Description: send data to LCD controller
+ ------------------------------------------------*/
+
+void lcd_data(char data)
+{
+	lcd_put(LCD_RS | (alt_u8)data);
+	if (lcd_cursor != LCD_CURSOR_UNKNOWN) lcd_cursor++;
+}
+
+/*------------------------------------------------/
+ Name:				lcd_init
+ Description: Initialize LCD before showing text.
+ 	 	 	  clock64_init() must be called first
+ 	 	 	  (CYCLES_USE_HW 0)
+ ------------------------------------------------*/
+
+void lcd_init(void)
+{
+	lcd_mark = cycles_now();
+	lcd_wait = 0;
+	lcd_bf_valid = 0;
+#if LCD_HAS_TRI
+	IOWR_ALTERA_AVALON_PIO_DIRECTION(LCD_BASE, LCD_CTRL | 0xFF);
+#endif
+
+	lcd_cmd(0b00111000);	// Set 2 line on LCD
+
+	lcd_cmd(0b00001100);	// Display On/Off control
+
+	lcd_cmd(0b00000110);	// Entry mode set
+
+	lcd_cmd(0b00000001);	// Clear screen
+
+	memset(lcd_fb, ' ', sizeof(lcd_fb));
+	memset(lcd_shown, ' ', sizeof(lcd_shown));
+	lcd_cursor = 0;
+	lcd_cgram_valid = 0;					// CGRAM is random after power-on
+}
+
+/*------------------------------------------------/
+ Name:				lcd_fb_flush
+ Description: queue set-cursor + data writes for
+ 	 	 	  the cells that changed. Runs separated
+ 	 	 	  by up to LCD_FB_GAP unchanged cells are
+ 	 	 	  merged, and the set-cursor is left out
+ 	 	 	  when the cursor is already in place.
+ 	 	 	  Nothing is queued when nothing changed
+ ------------------------------------------------*/
+
+void lcd_fb_flush(void)
+{
+	int row, col, end, next;
+
+	for (row = 0; row < LCD_ROWS; row++) {
+		col = 0;
+		while (col < LCD_COLS) {
+			if (lcd_fb[row][col] == lcd_shown[row][col]) {
+				col++;
+				continue;
+			}
+
+			end = col + 1;
+			for (next = end; next < LCD_COLS; next++) {
+				if (lcd_fb[row][next] != lcd_shown[row][next]) end = next + 1;
+				else if (next - end + 1 > LCD_FB_GAP) break;
+			}
+
+			if (lcd_cursor != (alt_u32)(row * 64 + col)) lcd_setcursor(row, col);
+			for (; col < end; col++) {
+				lcd_data(lcd_fb[row][col]);
+				lcd_shown[row][col] = lcd_fb[row][col];
+			}
+		}
+	}
+}
+
+/*------------------------------------------------/
+ Name:				lcd_glyph_set
+ Description: define CGRAM slot 0..7 (rows top to
+ 	 	 	  bottom, bit 4 = left pixel). Queues the
+ 	 	 	  9 writes only if the slot does not
+ 	 	 	  already hold these rows
+ ------------------------------------------------*/
+
+void lcd_glyph_set(alt_u32 slot, const alt_u8 rows[8])
+{
+	int i;
+
+	if (slot >= LCD_GLYPHS) return;
+	if ((lcd_cgram_valid >> slot & 1) && !memcmp(lcd_cgram[slot], rows, 8)) return;
+
+	lcd_cmd(0b01000000 | slot << 3);		// set CGRAM address, cursor is lost
+	for (i = 0; i < 8; i++)
+		lcd_data(rows[i]);
+	memcpy(lcd_cgram[slot], rows, 8);
+	lcd_cgram_valid |= 1 << slot;
+}
+
+#endif /* LCD_USE_HW */
+
+/*------------------------------------------------/
+ Name:				lcd_printtext
+ Description: print text or string on the screen
+ ------------------------------------------------*/
+
+void lcd_printtext(unsigned char string[])
+{
+	while (*string)
+		lcd_data(*string++);
+}
+
+/*------------------------------------------------/
+ Name:				lcd_setcursor
+ Description: set cursor position on display
+ ------------------------------------------------*/
+
+void lcd_setcursor(char row, char col)
+{
+	int row_char = 0;
+	if (row == 1) row_char = 64;
+	lcd_cmd(0b10000000 + row_char + col);
+	lcd_cursor = row_char + col;
+}
+
+/*------------------------------------------------/
+ Name:				lcd_fb_putc
+ Description: put one character in the framebuffer
+ ------------------------------------------------*/
+
+void lcd_fb_putc(char row, char col, unsigned char c)
+{
+	if (row < LCD_ROWS && col < LCD_COLS)
+		lcd_fb[(int)row][(int)col] = c;
+}
+
+/*------------------------------------------------/
+ Name:				lcd_fb_puts
+ Description: put a string in the framebuffer,
+ 	 	 	  clipped at the end of the row
+ ------------------------------------------------*/
+
+void lcd_fb_puts(char row, char col, unsigned char string[])
+{
+	if (row >= LCD_ROWS) return;
+
+	while (*string && col < LCD_COLS)
+		lcd_fb[(int)row][(int)col++] = *string++;
+}
+
+/*------------------------------------------------/
+ Name:				lcd_fb_bar
+ Description: draw level (0..LCD_BAR_LEVELS) as a
+ 	 	 	  bar over a whole framebuffer row. Uses
+ 	 	 	  CGRAM slots 0..3
+ ------------------------------------------------*/
+
+void lcd_fb_bar(char row, alt_u32 level)
+{
+	alt_u32 i;
+	int col;
+
+	if (row >= LCD_ROWS) return;
+	if (level > LCD_BAR_LEVELS) level = LCD_BAR_LEVELS;
+
+	for (i = 0; i < LCD_CELL_COLS - 1; i++)
+		lcd_glyph_set(i, lcd_bar_glyph[i]);
+
+	for (col = 0; col < LCD_COLS; col++) {
+		if (level >= LCD_CELL_COLS) {
+			lcd_fb[(int)row][col] = LCD_BLOCK;
+			level -= LCD_CELL_COLS;
+		} else if (level) {
+			lcd_fb[(int)row][col] = LCD_GLYPH(level - 1);
+			level = 0;
+		} else {
+			lcd_fb[(int)row][col] = ' ';
+		}
+	}
+}
@@ -0,0 +1,101 @@
+#ifndef LCD_H_
+#define LCD_H_
+
+#include <alt_types.h>
+#include <system.h>
+
+/*###################################################
+ 	 	 	 	 LCD 1602
+- Bits: 11
+- Order: RS  RW  E  D7  D6  D5  D4  D3  D2  D1  D0
+- 3 bit control (RS RW E):
+	+ 001: send command
+	+ 101: send data
+	+ EN (1->0): data was sent to LCD
+- lcd_cmd/lcd_data/lcd_printtext only queue bytes,
+  lcd_service() strobes them out one at a time and
+  must be called from the main loop, again after
+  the number of ticks it returns
+- LCD_BUSY_POLL 1 (bidirectional LCD PIO): before a
+  write the busy flag is read back (RS=0 RW=1), so
+  each byte goes out as soon as the controller is
+  done instead of after the worst-case time. No
+  poll before the shortest execution time
+- LCD_BUSY_POLL 0: fixed worst-case waits
+- lcd_fb_* draw into a 2x16 shadow framebuffer,
+  lcd_fb_flush() sends only the cells that differ
+  from what the panel shows. Cells drawn through
+  the framebuffer must not also be written with
+  lcd_printtext()/lcd_data()
+- lcd_glyph_set() keeps a copy of the 8 CGRAM
+  glyphs and only uploads one that changed. They
+  are shown as LCD_GLYPH(n) (codes 8..15, the same
+  CGRAM as 0..7 but usable in strings). Cells that
+  show a glyph follow a new upload by themselves
+- lcd_fb_bar(): a row as a bar of LCD_BAR_LEVELS,
+  one level per pixel column. Full cells use the
+  ROM block, glyphs 0..3 the 1..4 column steps, so
+  one level more changes one or two cells
+- LCD_USE_HW 1: lcd_refresh_0 core (ip/lcd_refresh)
+  drives the panel and sends every changed cell and
+  glyph by itself. lcd_fb_flush() is at most 8 TEXT
+  stores, a glyph 2 CGRAM stores, lcd_service() has
+  nothing to do. lcd_cmd() only knows clear display
+  and set DDRAM address. Must match LCD_HW_REFRESH
+  in mini.v
+- LCD_USE_HW 0: the LCD PIO, as above
+###################################################*/
+
+#define LCD_RS				0b10000000000
+#define LCD_RW				0b01000000000
+#define LCD_E				0b00100000000
+#define LCD_CTRL			(LCD_RS | LCD_RW | LCD_E)
+#define LCD_BF				0x80		// busy flag, AC in bits 6..0
+
+#ifndef LCD_USE_HW
+#define LCD_USE_HW			1
+#endif
+
+#ifndef LCD_BUSY_POLL
+#define LCD_BUSY_POLL		LCD_HAS_TRI	// needs D7..D0 readable
+#endif
+
+#define LCD_CORE_BASE		LCD_REFRESH_0_BASE
+
+#define LCD_QUEUE_SIZE		64			// power of 2
+
+#define LCD_ROWS			2
+#define LCD_COLS			16
+#define LCD_FB_GAP			1			// unchanged cells rewritten to save a set-cursor
+
+#define LCD_GLYPHS			8			// CGRAM slots of 5x8 pixels
+#define LCD_GLYPH(n)		(8 + (n))	// character code of CGRAM slot n
+#define LCD_BLOCK			0xFF		// all pixels on, character ROM A00
+#define LCD_CELL_COLS		5			// pixel columns per cell
+#define LCD_BAR_LEVELS		(LCD_COLS * LCD_CELL_COLS)
+
+/* HD44780 timings in cycles_now() ticks (50MHz) */
+#define LCD_PW_EH_TICKS		25			// enable pulse width >= 450ns
+#define LCD_EXEC_TICKS		2500		// command/data execution 37us, with margin
+#define LCD_CLEAR_TICKS		82000		// clear display/return home 1.52ms, with margin
+#define LCD_EXEC_MIN_TICKS	1250		// 25us: 37us at the fastest oscillator
+#define LCD_CLEAR_MIN_TICKS	57000		// 1.14ms, likewise
+#define LCD_POLL_TICKS		250			// busy flag poll interval after that
+
+void lcd_init(void);
+void lcd_cmd(char cmd);
+void lcd_data(char data);
+void lcd_printtext(unsigned char string[]);
+void lcd_setcursor(char row, char col);
+alt_u32 lcd_service(void);
+int  lcd_idle(void);
+alt_u32 lcd_status(void);
+
+void lcd_fb_putc(char row, char col, unsigned char c);
+void lcd_fb_puts(char row, char col, unsigned char string[]);
+void lcd_fb_flush(void);
+
+void lcd_glyph_set(alt_u32 slot, const alt_u8 rows[8]);
+void lcd_fb_bar(char row, alt_u32 level);
+
+#endif /* LCD_H_ */
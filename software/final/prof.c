@@ -0,0 +1,109 @@
+#include <string.h>
+#include <unistd.h>
+#include <sys/alt_alarm.h>
+#include <sys/alt_irq.h>
+#include "cycles.h"
+#include "deadline.h"
+#include "prof.h"
+
+#if PROF_ENABLE
+
+/*------------------------------------------------/
+ Name:				variables
+ Description: one record per region, kept in the
+ 	 	 	  same layout that goes over the wire
+ ------------------------------------------------*/
+
+static const char* const prof_names[PROF_REGIONS] = {
+	"loop", "lcd_service", "lcd_flush", "display_pwm", "switch", "pwm_isr", "speed"
+};
+
+static prof_record prof_rec[PROF_REGIONS];
+static alt_u32 prof_start[PROF_REGIONS];
+static deadline_timer prof_due;						// next dump, in system clock ticks
+
+/*------------------------------------------------/
+ Name:				prof_init
+ Description: clear all regions. cycles_now()
+ 	 	 	  must already be running
+ ------------------------------------------------*/
+
+void prof_init(void)
+{
+	int i;
+
+	memset(prof_rec, 0, sizeof(prof_rec));
+	for (i = 0; i < PROF_REGIONS; i++) {
+		strncpy(prof_rec[i].name, prof_names[i], PROF_NAME_LEN);
+		prof_rec[i].min = 0xFFFFFFFF;
+	}
+	deadline_start(&prof_due, alt_nticks(), PROF_DUMP_TICKS, PROF_DUMP_TICKS);
+}
+
+/*------------------------------------------------/
+ Name:				prof_enter
+ Description: remember when the region started
+ ------------------------------------------------*/
+
+void prof_enter(prof_region region)
+{
+	prof_start[region] = cycles_now();
+}
+
+/*------------------------------------------------/
+ Name:				prof_exit
+ Description: add the time since prof_enter() to
+ 	 	 	  the region. Bucket = bit length of the
+ 	 	 	  delta, so no division is needed
+ ------------------------------------------------*/
+
+void prof_exit(prof_region region)
+{
+	alt_u32 delta = cycles_now() - prof_start[region];
+	prof_record* rec = &prof_rec[region];
+	alt_u32 sum = rec->sum_lo + delta;
+	int b = delta ? 32 - __builtin_clz(delta) : 0;
+
+	if (b >= PROF_BUCKETS) b = PROF_BUCKETS - 1;
+
+	rec->count++;
+	if (delta < rec->min) rec->min = delta;
+	if (delta > rec->max) rec->max = delta;
+	rec->sum_hi += sum < rec->sum_lo;			// carry
+	rec->sum_lo = sum;
+	rec->bucket[b]++;
+}
+
+/*------------------------------------------------/
+ Name:				prof_dump
+ Description: write header + records to stdout
+ 	 	 	  (JTAG UART)
+ ------------------------------------------------*/
+
+void prof_dump(void)
+{
+	prof_header header;
+
+	header.magic   = PROF_MAGIC;
+	header.regions = PROF_REGIONS;
+	header.buckets = PROF_BUCKETS;
+	header.freq    = CYCLES_CLK;
+
+	write(STDOUT_FILENO, &header, sizeof(header));
+	write(STDOUT_FILENO, prof_rec, sizeof(prof_rec));
+}
+
+/*------------------------------------------------/
+ Name:				prof_poll
+ Description: dump every PROF_DUMP_TICKS, call it
+ 	 	 	  outside of any region
+ ------------------------------------------------*/
+
+void prof_poll(void)
+{
+	if (!deadline_poll(&prof_due, alt_nticks())) return;
+
+	prof_dump();
+}
+
+#endif /* PROF_ENABLE */
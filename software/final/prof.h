@@ -0,0 +1,73 @@
+#ifndef PROF_H_
+#define PROF_H_
+
+#include <alt_types.h>
+
+/*###################################################
+ 	 	 	 	 LOOP PROFILER
+- PROF_ENTER/PROF_EXIT take cycles_now() (cycles.h,
+  50MHz) and put the difference in the
+  region's histogram: count, min, max, sum and
+  log2 buckets (bucket b: 2^(b-1) <= cycles < 2^b)
+- PROF_POLL() writes a binary frame to the JTAG UART
+  every PROF_DUMP_TICKS, read it on the host with
+  software/host_sim/prof_report
+- Built only with -DPROF_ENABLE=1 (make
+  APP_CFLAGS_DEFINED_SYMBOLS=-DPROF_ENABLE=1),
+  otherwise every macro is empty
+###################################################*/
+
+#ifndef PROF_ENABLE
+#define PROF_ENABLE			0
+#endif
+
+#define PROF_BUCKETS		24			// last bucket also holds anything longer
+#define PROF_NAME_LEN		12
+#define PROF_DUMP_TICKS		5000		// system clock ticks (1 ms each)
+#define PROF_MAGIC			0x31465250	// "PRF1" in memory order
+
+typedef enum {
+	PROF_LOOP,							// one pass of the main loop
+	PROF_LCD_SERVICE,
+	PROF_LCD_FLUSH,
+	PROF_DISPLAY,						// display_PWM()
+	PROF_SWITCH,						// switch events + PWM update
+	PROF_PWM_ISR,						// timer_2 PWM interrupt
+	PROF_SPEED,							// one speed control step
+	PROF_REGIONS
+} prof_region;
+
+/* Frame: header then PROF_REGIONS records, little-endian, no padding */
+typedef struct {
+	alt_u32 magic;
+	alt_u16 regions;
+	alt_u16 buckets;
+	alt_u32 freq;						// timestamp clock in Hz
+} prof_header;
+
+typedef struct {
+	char    name[PROF_NAME_LEN];
+	alt_u32 count, min, max;
+	alt_u32 sum_lo, sum_hi;
+	alt_u32 bucket[PROF_BUCKETS];
+} prof_record;
+
+#if PROF_ENABLE
+void prof_init(void);
+void prof_enter(prof_region region);
+void prof_exit(prof_region region);
+void prof_poll(void);
+void prof_dump(void);
+
+#define PROF_INIT()			prof_init()
+#define PROF_ENTER(r)		prof_enter(r)
+#define PROF_EXIT(r)		prof_exit(r)
+#define PROF_POLL()			prof_poll()
+#else
+#define PROF_INIT()
+#define PROF_ENTER(r)
+#define PROF_EXIT(r)
+#define PROF_POLL()
+#endif
+
+#endif /* PROF_H_ */
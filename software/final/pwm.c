@@ -0,0 +1,626 @@
+#include <stddef.h>
+#include <altera_avalon_pio_regs.h>
+#include <altera_avalon_timer_regs.h>
+#include <motor_pwm_regs.h>
+#include <sys/alt_irq.h>
+#include <system.h>
+#include "prof.h"
+#include "pwm.h"
+
+/*------------------------------------------------/
+ Name:				variables
+ Description: per-channel settings, only changed
+ 	 	 	  with interrupts off (the H-bridge
+ 	 	 	  dead-time alarm writes them too)
+ ------------------------------------------------*/
+
+static volatile alt_u32 pwm_running;
+static alt_u32 pwm_period = PWM_PERIOD;				// clock cycles per period
+static alt_u32 pwm_freq = PWM_TIMER_FREQ / PWM_PERIOD;	// Hz, PWM_TIMER_FREQ / pwm_period
+static alt_u32 pwm_duty[PWM_CHANNELS];				// duty last handed to the backend
+static alt_u32 pwm_duty16[PWM_CHANNELS];			// same for pwm_set_duty16()
+static alt_u32 pwm_high[PWM_CHANNELS];				// HIGH count
+static alt_u32 pwm_frac[PWM_CHANNELS];				// + this many 1/65536 clock (dithered)
+static alt_u32 pwm_on[PWM_CHANNELS];				// MOTOR pins while HIGH
+static alt_u32 pwm_off[PWM_CHANNELS];				// MOTOR pins while LOW
+
+/*------------------------------------------------/
+ Name:				pwm_duty_lut
+ Description: HIGH clock counts for 0..100% of
+ 	 	 	 	  pwm_period, floor(d * period / 100)
+ ------------------------------------------------*/
+
+static alt_u32 pwm_duty_lut[101];
+
+/*------------------------------------------------/
+ Name:				pwm_lut_fill
+ Description: one divide for a Q16 step rounded
+ 	 	 	 	  up, the rest are additions. The
+ 	 	 	 	  rounding error stays below 1/100 of a
+ 	 	 	 	  clock over 100 steps, so every entry
+ 	 	 	 	  is the exact floor
+ ------------------------------------------------*/
+
+static void pwm_lut_fill(alt_u32 period)
+{
+	alt_u64 step = (((alt_u64)period << 16) + 99) / 100;
+	alt_u64 acc = 0;
+	alt_u32 d;
+
+	for (d = 0; d <= 100; d++, acc += step)
+		pwm_duty_lut[d] = (alt_u32)(acc >> 16);
+}
+
+#if PWM_USE_HW
+
+/*###################################################
+ 	 	 	 	 	 HARDWARE BACKEND
+- motor_pwm_0 counts the period and both compares
+  itself, the CPU only writes COMPARE/COMPARE_B on a
+  duty change and OUTPUT on a pattern change
+- Dithering is done by the core (DITHER/DITHER_B
+  accumulators), DITHER is only written when the
+  fraction changes
+###################################################*/
+
+static alt_u32 pwm_frac_core[PWM_CHANNELS];		// DITHER value in the core
+
+/*------------------------------------------------/
+ Name:				pwm_apply_high
+ Description: hand the HIGH count of a channel to
+ 	 	 	 	  the core, it is taken over at the
+ 	 	 	 	  next period edge
+ ------------------------------------------------*/
+
+static void pwm_apply_high(alt_u32 ch)
+{
+	if (ch == 0)
+		IOWR_MOTOR_PWM_COMPARE(PWM_CORE_BASE, pwm_high[0]);
+	else
+		IOWR_MOTOR_PWM_COMPARE_B(PWM_CORE_BASE, pwm_high[1]);
+
+	if (pwm_frac[ch] == pwm_frac_core[ch]) return;
+	pwm_frac_core[ch] = pwm_frac[ch];
+	if (ch == 0)
+		IOWR_MOTOR_PWM_DITHER(PWM_CORE_BASE, pwm_frac[0]);
+	else
+		IOWR_MOTOR_PWM_DITHER_B(PWM_CORE_BASE, pwm_frac[1]);
+}
+
+/*------------------------------------------------/
+ Name:				pwm_apply_pins
+ Description: pack the pin patterns of both
+ 	 	 	 	  channels into the OUTPUT register
+ ------------------------------------------------*/
+
+static void pwm_apply_pins(void)
+{
+	alt_u32 ch, out = 0;
+
+	for (ch = 0; ch < PWM_CHANNELS; ch++)
+		out |= (pwm_on[ch]  << MOTOR_PWM_OUTPUT_A_HIGH_OFST |
+				pwm_off[ch] << MOTOR_PWM_OUTPUT_A_LOW_OFST) << (ch * MOTOR_PWM_OUTPUT_CHANNEL_OFST);
+	IOWR_MOTOR_PWM_OUTPUT(PWM_CORE_BASE, out);
+}
+
+/*------------------------------------------------/
+ Name:				pwm_apply_period
+ Description: new PERIOD and both COMPAREs. HOLD
+ 	 	 	 	  keeps the core on the old values while
+ 	 	 	 	  they are written, so a period edge in
+ 	 	 	 	  between cannot pair the new period
+ 	 	 	 	  with an old compare
+ ------------------------------------------------*/
+
+static void pwm_apply_period(void)
+{
+	alt_u32 enable = pwm_running ? MOTOR_PWM_ENABLE_MSK : 0;
+	alt_u32 ch;
+
+	IOWR_MOTOR_PWM_ENABLE(PWM_CORE_BASE, enable | MOTOR_PWM_ENABLE_HOLD_MSK);
+	IOWR_MOTOR_PWM_PERIOD(PWM_CORE_BASE, pwm_period);
+	for (ch = 0; ch < PWM_CHANNELS; ch++)
+		pwm_apply_high(ch);
+	IOWR_MOTOR_PWM_ENABLE(PWM_CORE_BASE, enable);
+}
+
+/*------------------------------------------------/
+ Name:				pwm_init
+ Description: stop the core, set the period, all
+ 	 	 	 	  channels 0% with all pins low
+ ------------------------------------------------*/
+
+void pwm_init(void)
+{
+	alt_u32 ch;
+
+	pwm_period = PWM_PERIOD;
+	pwm_freq = PWM_TIMER_FREQ / PWM_PERIOD;
+	pwm_lut_fill(pwm_period);
+
+	IOWR_MOTOR_PWM_ENABLE(PWM_CORE_BASE, 0);
+	IOWR_MOTOR_PWM_PERIOD(PWM_CORE_BASE, pwm_period);
+
+	IOWR_MOTOR_PWM_DITHER(PWM_CORE_BASE, 0);
+	IOWR_MOTOR_PWM_DITHER_B(PWM_CORE_BASE, 0);
+
+	pwm_running = 0;
+	for (ch = 0; ch < PWM_CHANNELS; ch++) {
+		pwm_duty[ch] = pwm_duty16[ch] = PWM_DUTY_NONE;
+		pwm_high[ch] = pwm_frac[ch] = pwm_frac_core[ch] = 0;
+		pwm_on[ch] = pwm_off[ch] = 0;
+		pwm_apply_high(ch);
+	}
+	pwm_apply_pins();
+}
+
+/*------------------------------------------------/
+ Name:				pwm_start
+ Description: start sending PWM pulses to the
+ 	 	 	 	  L298 H-bridge (no effect if running)
+ ------------------------------------------------*/
+
+void pwm_start(void)
+{
+	if (pwm_running) return;
+
+	pwm_running = 1;
+	IOWR_MOTOR_PWM_ENABLE(PWM_CORE_BASE, MOTOR_PWM_ENABLE_MSK);
+}
+
+/*------------------------------------------------/
+ Name:				pwm_stop
+ Description: stop the core, all outputs go low
+ 	 	 	 	  on the next clock
+ ------------------------------------------------*/
+
+void pwm_stop(void)
+{
+	if (!pwm_running) return;
+
+	pwm_running = 0;
+	IOWR_MOTOR_PWM_ENABLE(PWM_CORE_BASE, 0);
+}
+
+#else /* !PWM_USE_HW */
+
+/*###################################################
+ 	 	 	 	 	 SOFTWARE BACKEND
+- timer_2 one-shot per phase, the ISR writes the
+  phase's pin pattern to MOTOR
+###################################################*/
+
+/*------------------------------------------------/
+ Name:				pwm_frame
+ Description: one period as a list of phases. The
+ 	 	 	 	  phase ends where a channel's HIGH
+ 	 	 	 	  count runs out; phases with the same
+ 	 	 	 	  pins are merged, so 0%/100% and equal
+ 	 	 	 	  duties give fewer edges. edge[] is the
+ 	 	 	 	  phase a channel's dither carry makes
+ 	 	 	 	  one clock longer (and the next one
+ 	 	 	 	  shorter), frac[] is 0 if there is none
+ ------------------------------------------------*/
+
+typedef struct {
+	alt_u32 phases;
+	alt_u32 pins[PWM_CHANNELS + 1];
+	alt_u32 ticks[PWM_CHANNELS + 1];
+	alt_u32 frac[PWM_CHANNELS];
+	alt_u32 edge[PWM_CHANNELS];
+} pwm_frame;
+
+static volatile pwm_frame pwm_next;				// built by the setters
+static pwm_frame pwm_cur;							// the running period, ISR only
+static alt_u32 pwm_phase;
+static alt_u32 pwm_acc[PWM_CHANNELS];				// sigma-delta accumulators, ISR only
+static alt_u32 pwm_pins = 0xFFFFFFFF;				// last value written to MOTOR
+
+/*------------------------------------------------/
+ Name:				pwm_load
+ Description: start timer_2 as one-shot for the
+ 	 	 	 	  given number of clock cycles
+ ------------------------------------------------*/
+
+static void pwm_load(alt_u32 ticks)
+{
+	ticks = ticks - 1;							// timer counts period+1 cycles
+	IOWR_ALTERA_AVALON_TIMER_PERIODL(PWM_TIMER_BASE, ticks & 0xFFFF);
+	IOWR_ALTERA_AVALON_TIMER_PERIODH(PWM_TIMER_BASE, ticks >> 16);
+	IOWR_ALTERA_AVALON_TIMER_CONTROL(PWM_TIMER_BASE,
+			ALTERA_AVALON_TIMER_CONTROL_ITO_MSK |
+			ALTERA_AVALON_TIMER_CONTROL_START_MSK);
+}
+
+/*------------------------------------------------/
+ Name:				pwm_out
+ Description: drive the four pins, nothing if they
+ 	 	 	 	  do not change. With outset/outclear
+ 	 	 	 	  only the pins that change are written
+ 	 	 	 	  (clear first, so a pattern change
+ 	 	 	 	  passes through coast, never through
+ 	 	 	 	  brake) and other MOTOR bits are left
+ 	 	 	 	  alone without a read-modify-write.
+ 	 	 	 	  One write per edge of a single channel
+ ------------------------------------------------*/
+
+static void pwm_out(alt_u32 pins)
+{
+#if MOTOR_BIT_MODIFYING_OUTPUT_REGISTER
+	alt_u32 set = pins & ~pwm_pins, clear = pwm_pins & ~pins;
+
+	if (!set && !clear) return;
+
+	pwm_pins = pins;
+	if (clear) IOWR_ALTERA_AVALON_PIO_CLEAR_BITS(MOTOR_BASE, clear);
+	if (set)   IOWR_ALTERA_AVALON_PIO_SET_BITS(MOTOR_BASE, set);
+#else
+	if (pins == pwm_pins) return;
+
+	pwm_pins = pins;
+	IOWR_ALTERA_AVALON_PIO_DATA(MOTOR_BASE, pins);
+#endif
+}
+
+/*------------------------------------------------/
+ Name:				pwm_phase_start
+ Description: time the current phase and drive
+ 	 	 	 	  its pins
+ ------------------------------------------------*/
+
+static void pwm_phase_start(void)
+{
+	pwm_load(pwm_cur.ticks[pwm_phase]);
+	pwm_out(pwm_cur.pins[pwm_phase]);
+}
+
+/*------------------------------------------------/
+ Name:				pwm_period_start
+ Description: take over the latest phase list,
+ 	 	 	 	  apply the dither carries and begin a
+ 	 	 	 	  new period
+ ------------------------------------------------*/
+
+static void pwm_period_start(void)
+{
+	alt_u32 ch, p;
+
+	pwm_cur = *(pwm_frame*)&pwm_next;
+	for (ch = 0; ch < PWM_CHANNELS; ch++) {
+		pwm_acc[ch] += pwm_cur.frac[ch];
+		if (pwm_acc[ch] >= PWM_DUTY16_FULL) {
+			pwm_acc[ch] -= PWM_DUTY16_FULL;
+			p = pwm_cur.edge[ch];
+			pwm_cur.ticks[p]++;
+			pwm_cur.ticks[p + 1]--;
+		}
+	}
+	pwm_phase = 0;
+	pwm_phase_start();
+}
+
+/*------------------------------------------------/
+ Name:				pwm_isr
+ Description: timer_2 timeout: next phase, or the
+ 	 	 	 	  period edge after the last one
+ ------------------------------------------------*/
+
+static void pwm_isr(void* context)
+{
+	PROF_ENTER(PROF_PWM_ISR);
+	IOWR_ALTERA_AVALON_TIMER_STATUS(PWM_TIMER_BASE, 0);	// clear the interrupt
+
+	if (++pwm_phase < pwm_cur.phases)
+		pwm_phase_start();
+	else
+		pwm_period_start();
+	PROF_EXIT(PROF_PWM_ISR);
+}
+
+/*------------------------------------------------/
+ Name:				pwm_build
+ Description: cut the period at every channel's
+ 	 	 	 	  HIGH count into the next phase list
+ ------------------------------------------------*/
+
+static void pwm_build(void)
+{
+	pwm_frame* f = (pwm_frame*)&pwm_next;
+	alt_u32 ch, start, end, pins, n = 0;
+
+	for (start = 0; start < pwm_period; start = end) {
+		end = pwm_period;
+		pins = 0;
+		for (ch = 0; ch < PWM_CHANNELS; ch++) {
+			if (start < pwm_high[ch]) {
+				pins |= pwm_on[ch];
+				if (pwm_high[ch] < end) end = pwm_high[ch];
+			} else {
+				pins |= pwm_off[ch];
+			}
+		}
+		if (n && f->pins[n - 1] == pins) {
+			f->ticks[n - 1] += end - start;
+		} else {
+			f->pins[n] = pins;
+			f->ticks[n] = end - start;
+			n++;
+		}
+	}
+	f->phases = n;
+
+	/* a carry needs the channel's edge to still exist after merging
+	 * and a following phase that can give up one clock. Channels with
+	 * the same HIGH count share the edge and may all carry in the same
+	 * period, so that phase must be able to give up PWM_CHANNELS */
+	for (ch = 0; ch < PWM_CHANNELS; ch++) {
+		f->frac[ch] = 0;
+		f->edge[ch] = 0;
+		for (end = 0, start = 0; start + 1 < n; start++) {
+			end += f->ticks[start];
+			if (end == pwm_high[ch] && f->ticks[start + 1] > PWM_CHANNELS) {
+				f->frac[ch] = pwm_frac[ch];
+				f->edge[ch] = start;
+			}
+		}
+	}
+}
+
+/*------------------------------------------------/
+ Name:				pwm_apply_high, pwm_apply_pins,
+ 	 	 	 	  pwm_apply_period
+ Description: any change rebuilds the whole phase
+ 	 	 	 	  list, the ISR takes it over at the
+ 	 	 	 	  next period edge in one piece
+ ------------------------------------------------*/
+
+static void pwm_apply_high(alt_u32 ch)
+{
+	pwm_build();
+}
+
+static void pwm_apply_pins(void)
+{
+	pwm_build();
+}
+
+static void pwm_apply_period(void)
+{
+	pwm_build();
+}
+
+/*------------------------------------------------/
+ Name:				pwm_init
+ Description: stop timer_2, all channels 0% with
+ 	 	 	 	 	  all pins low, register the PWM
+ 	 	 	 	 	  interrupt
+ ------------------------------------------------*/
+
+void pwm_init(void)
+{
+	alt_u32 ch;
+
+	pwm_period = PWM_PERIOD;
+	pwm_freq = PWM_TIMER_FREQ / PWM_PERIOD;
+	pwm_lut_fill(pwm_period);
+
+	IOWR_ALTERA_AVALON_TIMER_CONTROL(PWM_TIMER_BASE, ALTERA_AVALON_TIMER_CONTROL_STOP_MSK);
+	IOWR_ALTERA_AVALON_TIMER_STATUS(PWM_TIMER_BASE, 0);
+	pwm_pins = 0xFFFFFFFF;
+	pwm_out(0);
+
+	pwm_running = 0;
+	for (ch = 0; ch < PWM_CHANNELS; ch++) {
+		pwm_duty[ch] = pwm_duty16[ch] = PWM_DUTY_NONE;
+		pwm_high[ch] = pwm_frac[ch] = pwm_acc[ch] = 0;
+		pwm_on[ch] = pwm_off[ch] = 0;
+	}
+	pwm_build();
+
+	alt_ic_isr_register(PWM_TIMER_IRQ_IC, PWM_TIMER_IRQ, pwm_isr, NULL, NULL);
+}
+
+/*------------------------------------------------/
+ Name:				pwm_start
+ Description: start sending PWM pulses to the
+ 	 	 	 	  L298 H-bridge (no effect if running)
+ ------------------------------------------------*/
+
+void pwm_start(void)
+{
+	alt_irq_context context;
+
+	if (pwm_running) return;
+
+	context = alt_irq_disable_all();
+	pwm_running = 1;
+	pwm_period_start();
+	alt_irq_enable_all(context);
+}
+
+/*------------------------------------------------/
+ Name:				pwm_stop
+ Description: stop timer_2 and drive all pins low
+ ------------------------------------------------*/
+
+void pwm_stop(void)
+{
+	alt_irq_context context;
+
+	if (!pwm_running) return;
+
+	context = alt_irq_disable_all();
+	IOWR_ALTERA_AVALON_TIMER_CONTROL(PWM_TIMER_BASE, ALTERA_AVALON_TIMER_CONTROL_STOP_MSK);
+	IOWR_ALTERA_AVALON_TIMER_STATUS(PWM_TIMER_BASE, 0);
+	pwm_running = 0;
+	pwm_out(0);
+	alt_irq_enable_all(context);
+}
+
+#endif /* PWM_USE_HW */
+
+/*------------------------------------------------/
+ Name:				pwm_set_duty
+ Description: Update on time and off time for PWM
+ 	 	 	 	 	  pulse depending on duty cycle change.
+ 	 	 	 	 	  Only a table load, and nothing at all
+ 	 	 	 	 	  if the duty is unchanged. Takes effect
+ 	 	 	 	 	  on the next period edge
+ ------------------------------------------------*/
+
+void pwm_set_duty(alt_u32 ch, alt_u32 duty)
+{
+	alt_irq_context context;
+
+	if (duty > 100) duty = 100;
+	if (duty == pwm_duty[ch]) return;
+
+/* Using DE-10 kit with frequency 50MHz --> 1 clock cycle corresponds 20 nanosecond
+ * So, when applying required frequency 1kHz --> 1 required clock cycle corresponds 1 millisecond
+ * --> 1 millisecond of 1 required clock cycle corresponds 50000 clock cycle on DE-10 kit
+ * --> From above, the number of clock cycle using for duty cycle be determined
+ *     ahead of time in pwm_duty_lut[] (refilled by pwm_set_freq()). */
+	context = alt_irq_disable_all();
+	pwm_high[ch] = pwm_duty_lut[duty];
+	pwm_frac[ch] = 0;
+	pwm_duty[ch] = duty;
+	pwm_duty16[ch] = PWM_DUTY_NONE;
+	pwm_apply_high(ch);
+	alt_irq_enable_all(context);
+}
+
+/*------------------------------------------------/
+ Name:				pwm_set_duty16
+ Description: duty in 1/65536 (0..PWM_DUTY16_FULL).
+ 	 	 	 	 	  The HIGH count is the integer part of
+ 	 	 	 	 	  duty * period / 65536, the rest
+ 	 	 	 	 	  is dithered over the periods. Nothing
+ 	 	 	 	 	  at all if the duty is unchanged
+ ------------------------------------------------*/
+
+void pwm_set_duty16(alt_u32 ch, alt_u32 duty)
+{
+	alt_irq_context context;
+	alt_u64 high;
+
+	if (duty > PWM_DUTY16_FULL) duty = PWM_DUTY16_FULL;
+	if (duty == pwm_duty16[ch]) return;
+
+	high = (alt_u64)duty * pwm_period;				// one 32x32 multiply, only on a change
+
+	context = alt_irq_disable_all();
+	pwm_high[ch] = (alt_u32)(high >> 16);
+	pwm_frac[ch] = PWM_DITHER ? (alt_u32)high & 0xFFFF : 0;
+	pwm_duty[ch] = PWM_DUTY_NONE;
+	pwm_duty16[ch] = duty;
+	pwm_apply_high(ch);
+	alt_irq_enable_all(context);
+}
+
+/*------------------------------------------------/
+ Name:				pwm_set_ticks
+ Description: set the HIGH time directly in clock
+ 	 	 	 	 	  cycles (0..pwm_get_period()). Takes
+ 	 	 	 	 	  effect on the next period edge
+ ------------------------------------------------*/
+
+void pwm_set_ticks(alt_u32 ch, alt_u32 high)
+{
+	alt_irq_context context;
+
+	if (high > pwm_period) high = pwm_period;
+
+	context = alt_irq_disable_all();
+	pwm_high[ch] = high;
+	pwm_frac[ch] = 0;
+	pwm_duty[ch] = pwm_duty16[ch] = PWM_DUTY_NONE;
+	pwm_apply_high(ch);
+	alt_irq_enable_all(context);
+}
+
+/*------------------------------------------------/
+ Name:				pwm_set_pins
+ Description: MOTOR pins a channel drives during
+ 	 	 	 	 	  its HIGH and its LOW phase. Takes
+ 	 	 	 	 	  effect on the next period edge
+ ------------------------------------------------*/
+
+void pwm_set_pins(alt_u32 ch, alt_u32 on, alt_u32 off)
+{
+	alt_irq_context context;
+
+	context = alt_irq_disable_all();
+	pwm_on[ch] = on;
+	pwm_off[ch] = off;
+	pwm_apply_pins();
+	alt_irq_enable_all(context);
+}
+
+/*------------------------------------------------/
+ Name:				pwm_set_freq
+ Description: PWM frequency in Hz, clamped to
+ 	 	 	 	 	  PWM_FREQ_MIN..PWM_FREQ_MAX. Each
+ 	 	 	 	 	  channel keeps its duty: whole percents
+ 	 	 	 	 	  from the refilled table, anything
+ 	 	 	 	 	  else scaled in 1/65536 clock. The
+ 	 	 	 	 	  divides are done before interrupts are
+ 	 	 	 	 	  turned off, the new period and HIGH
+ 	 	 	 	 	  counts start on the same period edge.
+ 	 	 	 	 	  Returns the frequency actually set
+ ------------------------------------------------*/
+
+alt_u32 pwm_set_freq(alt_u32 freq)
+{
+	alt_u32 high[PWM_CHANNELS], frac[PWM_CHANNELS];
+	alt_irq_context context;
+	alt_u32 ch, period;
+	alt_u64 level;
+
+	if (freq < PWM_FREQ_MIN) freq = PWM_FREQ_MIN;
+	if (freq > PWM_FREQ_MAX) freq = PWM_FREQ_MAX;
+	period = PWM_TIMER_FREQ / freq;
+	if (period == pwm_period) return pwm_freq;
+
+	/* only the main loop changes the table and the HIGH counts,
+	 * interrupt context only touches the pin patterns */
+	pwm_lut_fill(period);
+	for (ch = 0; ch < PWM_CHANNELS; ch++) {
+		if (pwm_duty[ch] != PWM_DUTY_NONE) {
+			high[ch] = pwm_duty_lut[pwm_duty[ch]];
+			frac[ch] = 0;
+		} else {
+			level = (((alt_u64)pwm_high[ch] << 16) | pwm_frac[ch]) * period / pwm_period;
+			high[ch] = (alt_u32)(level >> 16);
+			frac[ch] = PWM_DITHER ? (alt_u32)level & 0xFFFF : 0;
+		}
+	}
+
+	context = alt_irq_disable_all();
+	pwm_period = period;
+	for (ch = 0; ch < PWM_CHANNELS; ch++) {
+		pwm_high[ch] = high[ch];
+		pwm_frac[ch] = frac[ch];
+		pwm_duty16[ch] = PWM_DUTY_NONE;			// rescaled, the next value is recomputed
+	}
+	pwm_apply_period();
+	alt_irq_enable_all(context);
+
+	pwm_freq = PWM_TIMER_FREQ / period;
+	return pwm_freq;
+}
+
+/*------------------------------------------------/
+ Name:				pwm_get_freq, pwm_get_period
+ Description: the running frequency in Hz and the
+ 	 	 	 	 	  period in clock cycles
+ ------------------------------------------------*/
+
+alt_u32 pwm_get_freq(void)
+{
+	return pwm_freq;
+}
+
+alt_u32 pwm_get_period(void)
+{
+	return pwm_period;
+}
@@ -0,0 +1,77 @@
+#ifndef PWM_H_
+#define PWM_H_
+
+#include <alt_types.h>
+#include <system.h>
+
+/*###################################################
+ 	 	 	 	 	 PWM ENGINE
+- PWM_CHANNELS channels share one period. Each has
+  a HIGH count and two MOTOR pin patterns, one for
+  its HIGH and one for its LOW phase (hbridge.c).
+  The patterns of all channels are ORed, so every
+  edge is one write of all four pins, or with
+  MOTOR outset/outclear one write per changed
+  direction (clear before set, through coast)
+- PWM_USE_HW 1: motor_pwm_0 core (ip/motor_pwm)
+  generates the waveform, a duty change is one
+  COMPARE write. Must match MOTOR_HW_PWM in mini.v
+- PWM_USE_HW 0: timer_2 ISR drives MOTOR_BASE
+  (timer_1 stays the HAL timestamp). Each period is
+  cut into at most PWM_CHANNELS + 1 phases of one
+  pin pattern, the phase list is rebuilt on a change
+  and taken over by the ISR on the next period edge
+- HIGH counts for whole percents come from a table
+  that pwm_set_freq() refills, pwm_set_duty() with an
+  unchanged duty is a no-op
+- pwm_set_freq(): PWM_FREQ_MIN..PWM_FREQ_MAX at run
+  time, period = PWM_TIMER_FREQ / f. Every channel
+  keeps its duty, the new period and HIGH counts are
+  taken over together at the next period edge
+- PWM_DITHER 1: pwm_set_duty16() keeps the fraction
+  of a clock below the HIGH count and a first-order
+  sigma-delta adds one clock to the HIGH phase in
+  that fraction of the periods, so the average duty
+  has 16-bit resolution at any PWM_FREQ. The carry
+  moves an existing edge, no extra edge or bus write
+###################################################*/
+
+#ifndef PWM_USE_HW
+#define PWM_USE_HW			1
+#endif
+
+#ifndef PWM_DITHER
+#define PWM_DITHER			1
+#endif
+
+#ifndef PWM_FREQ
+#define PWM_FREQ			1000					// Hz after pwm_init()
+#endif
+
+#define PWM_FREQ_MIN		100						// Hz, 500000 clocks
+#define PWM_FREQ_MAX		40000					// Hz, 1250 clocks
+
+#define PWM_CORE_BASE		MOTOR_PWM_0_BASE
+#define PWM_TIMER_BASE		TIMER_2_BASE
+#define PWM_TIMER_IRQ		TIMER_2_IRQ
+#define PWM_TIMER_IRQ_IC	TIMER_2_IRQ_INTERRUPT_CONTROLLER_ID
+#define PWM_TIMER_FREQ		TIMER_2_FREQ
+
+/* 1kHz PWM: 50MHz / 1kHz = 50000 clock cycles per period */
+#define PWM_PERIOD			(PWM_TIMER_FREQ / PWM_FREQ)	// after pwm_init(), see pwm_get_period()
+#define PWM_DUTY_NONE		0xFFFFFFFF				// no duty selected yet
+#define PWM_CHANNELS		2						// motor_pwm_0 COMPARE and COMPARE_B
+#define PWM_DUTY16_FULL		65536					// pwm_set_duty16() for 100%
+
+void pwm_init(void);
+void pwm_set_duty(alt_u32 ch, alt_u32 duty);
+void pwm_set_duty16(alt_u32 ch, alt_u32 duty);
+void pwm_set_ticks(alt_u32 ch, alt_u32 high);
+void pwm_set_pins(alt_u32 ch, alt_u32 on, alt_u32 off);
+alt_u32 pwm_set_freq(alt_u32 freq);
+alt_u32 pwm_get_freq(void);
+alt_u32 pwm_get_period(void);
+void pwm_start(void);
+void pwm_stop(void);
+
+#endif /* PWM_H_ */
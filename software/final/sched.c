@@ -0,0 +1,200 @@
+#include <stddef.h>
+#include <stdio.h>
+#include <sys/alt_irq.h>
+#include <system.h>
+#include "clock64.h"
+#include "cycles.h"
+#include "fixmath.h"
+#include "sched.h"
+
+/*------------------------------------------------/
+ Name:				variables
+ Description: registered tasks, in the order of
+ 	 	 	  sched_add() (ties run in that order)
+ ------------------------------------------------*/
+
+static sched_task* sched_tasks[SCHED_MAX_TASKS];
+static alt_u32 sched_count;
+
+/*------------------------------------------------/
+ Name:				load
+ Description: busy cycles in the open window, and
+ 	 	 	  what the closed windows came to
+ ------------------------------------------------*/
+
+/* busy cycles to 1/1000 of the window, exact enough up to a full window */
+#if SCHED_LOAD_WINDOW != 5000000
+#error "SCHED_LOAD_PERMILLE() needs a new fraction"
+#endif
+#define SCHED_LOAD_PERMILLE(busy)	FIX_DIV(busy, 5000, 22)
+
+static deadline_timer sched_window;
+static alt_u32 sched_busy;						// open window
+static alt_u32 sched_busy_last, sched_load_last, sched_load_max;
+static alt_u32 sched_windows;
+
+/*------------------------------------------------/
+ Name:				sched_init
+ Description: forget all tasks, cycles_now()
+ 	 	 	  must already run
+ ------------------------------------------------*/
+
+void sched_init(void)
+{
+	sched_count = 0;
+	sched_busy = sched_busy_last = sched_load_last = sched_load_max = 0;
+	sched_windows = 0;
+	deadline_start(&sched_window, cycles_now(), SCHED_LOAD_WINDOW, SCHED_LOAD_WINDOW);
+}
+
+/*------------------------------------------------/
+ Name:				sched_load_close
+ Description: end of a load window: busy cycles to
+ 	 	 	  1/1000, a task longer than the window
+ 	 	 	  counts as full load
+ ------------------------------------------------*/
+
+static void sched_load_close(void)
+{
+	alt_u32 busy = sched_busy < SCHED_LOAD_WINDOW ? sched_busy : SCHED_LOAD_WINDOW;
+
+	sched_busy_last = busy;
+	sched_load_last = SCHED_LOAD_PERMILLE(busy);
+	if (sched_load_last > SCHED_LOAD_FULL) sched_load_last = SCHED_LOAD_FULL;
+	if (sched_load_last > sched_load_max) sched_load_max = sched_load_last;
+	sched_busy = 0;
+	sched_windows++;
+}
+
+/*------------------------------------------------/
+ Name:				sched_add
+ Description: register a task. A periodic task is
+ 	 	 	  released at once, rel_deadline 0 means
+ 	 	 	  the period (or due at once when woken)
+ ------------------------------------------------*/
+
+void sched_add(sched_task* task, const char* name, void (*run)(void),
+               alt_u32 period, alt_u32 rel_deadline)
+{
+	if (sched_count >= SCHED_MAX_TASKS) return;
+
+	task->name = name;
+	task->run = run;
+	task->rel_deadline = rel_deadline ? rel_deadline : period;
+	task->runs = task->late = task->max = 0;
+	task->sum = 0;
+	task->ready = 0;
+	deadline_start(&task->release, cycles_now(), 0, period);
+	if (period) sched_wake(task, 0);
+
+	sched_tasks[sched_count++] = task;
+}
+
+/*------------------------------------------------/
+ Name:				sched_wake
+ Description: release a task delay cycles from now.
+ 	 	 	  A periodic task is re-anchored to the
+ 	 	 	  new release time
+ ------------------------------------------------*/
+
+void sched_wake(sched_task* task, alt_u32 delay)
+{
+	alt_irq_context context = alt_irq_disable_all();
+
+	task->release.next = cycles_now() + delay;
+	task->deadline = task->release.next + task->rel_deadline;
+	task->ready = 1;
+	alt_irq_enable_all(context);
+}
+
+/*------------------------------------------------/
+ Name:				sched_run
+ Description: run the released task with the
+ 	 	 	  earliest deadline. Returns 0 if no
+ 	 	 	  task was due
+ ------------------------------------------------*/
+
+int sched_run(void)
+{
+	sched_task *t, *best = NULL;
+	alt_u32 i, now, due, used;
+	alt_irq_context context;
+
+	context = alt_irq_disable_all();				// sched_wake() may run in an ISR
+	now = cycles_now();
+	if (deadline_poll(&sched_window, now)) sched_load_close();
+	for (i = 0; i < sched_count; i++) {
+		t = sched_tasks[i];
+		if (!t->ready || deadline_left(&t->release, now) > 0) continue;
+		if (!best || (alt_32)(t->deadline - best->deadline) < 0) best = t;
+	}
+	if (!best) {
+		alt_irq_enable_all(context);
+		return 0;
+	}
+
+	due = best->deadline;
+	if (best->release.period) {
+		deadline_advance(&best->release, now);
+		best->deadline = best->release.next + best->rel_deadline;
+	} else {
+		best->ready = 0;
+	}
+	alt_irq_enable_all(context);
+
+	best->run();
+
+	used = cycles_now();
+	if ((alt_32)(used - due) > 0) best->late++;
+	used -= now;
+	sched_busy += used;
+	best->runs++;
+	best->sum += used;
+	if (used > best->max) best->max = used;
+	return 1;
+}
+
+/*------------------------------------------------/
+ Name:				sched_load, sched_load_peak
+ Description: CPU load of the last complete window
+ 	 	 	  and the highest so far, in 1/1000
+ ------------------------------------------------*/
+
+alt_u32 sched_load(void)
+{
+	return sched_load_last;
+}
+
+alt_u32 sched_load_peak(void)
+{
+	return sched_load_max;
+}
+
+/*------------------------------------------------/
+ Name:				sched_report
+ Description: uptime, one line per task on stdout
+ 	 	 	  (JTAG UART), the average is the only
+ 	 	 	  divide, then the load counters
+ ------------------------------------------------*/
+
+void sched_report(void)
+{
+	sched_task* t;
+	alt_u32 i, last = fix_div10(sched_load_last), peak = fix_div10(sched_load_max);
+	alt_u64 us = clock64_to_us(clock64_now());
+	alt_u32 s = fix_mulhi64(us, FIX_RECIP64(1000000));		// exact for 476 days
+
+	printf("uptime %lu.%06lu s\n", (unsigned long)s, (unsigned long)(us - (alt_u64)s * 1000000));
+	printf("%-10s %7s %7s %7s %9s %9s\n", "task", "runs", "late", "skipped", "avg cyc", "max cyc");
+	for (i = 0; i < sched_count; i++) {
+		t = sched_tasks[i];
+		printf("%-10s %7lu %7lu %7lu %9lu %9lu\n", t->name, (unsigned long)t->runs,
+				(unsigned long)t->late, (unsigned long)t->release.overruns,
+				(unsigned long)(t->runs ? t->sum / t->runs : 0), (unsigned long)t->max);
+	}
+	printf("load %lu.%lu%% peak %lu.%lu%%, last window busy %lu idle %lu cyc, %lu windows\n",
+			(unsigned long)last, (unsigned long)(sched_load_last - last * 10),
+			(unsigned long)peak, (unsigned long)(sched_load_max - peak * 10),
+			(unsigned long)sched_busy_last, (unsigned long)(SCHED_LOAD_WINDOW - sched_busy_last),
+			(unsigned long)sched_windows);
+}
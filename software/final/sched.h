@@ -0,0 +1,70 @@
+#ifndef SCHED_H_
+#define SCHED_H_
+
+#include <alt_types.h>
+#include <system.h>
+#include "cycles.h"
+#include "deadline.h"
+
+/*###################################################
+ 	 	 	 	 TASK SCHEDULER
+- Cooperative, run from the main loop: sched_run()
+  picks one task whose release time has come and
+  runs it to completion, earliest absolute deadline
+  first. Times are cycles_now() cycles (cycles.h)
+- Periodic task: released every period, deadline
+  = release + relative deadline. The releases are a
+  deadline_timer (deadline.h), so a late run does
+  not shift the rate; a task that fell a whole
+  period behind skips the missed releases
+- period 0: only runs after sched_wake(), which may
+  be called from interrupt context
+- Accounting per task: runs, cycles (sum, max), runs
+  that finished after their deadline and skipped
+  releases
+- CPU load: the cycles spent in run() per window of
+  SCHED_LOAD_WINDOW, the rest of the window is idle
+  (the main loop found no task due). An interrupt is
+  counted where it lands, in a task or in idle time.
+  sched_load() is the last complete window in 1/1000
+- sched_report() prints the task table, the load and
+  the busy/idle cycle counters of the last window on
+  the JTAG UART (nios2-terminal), the application
+  runs it every SCHED_REPORT_PERIOD. Built in by
+  default, -DSCHED_REPORT=0 (make
+  APP_CFLAGS_DEFINED_SYMBOLS=-DSCHED_REPORT=0) leaves
+  it out
+###################################################*/
+
+#ifndef SCHED_REPORT
+#define SCHED_REPORT		1
+#endif
+
+#define SCHED_CLK			CYCLES_CLK
+#define SCHED_HZ(f)			(SCHED_CLK / (f))		// period for a rate in Hz
+#define SCHED_MAX_TASKS		12
+#define SCHED_LOAD_WINDOW	SCHED_HZ(10)			// 100ms
+#define SCHED_LOAD_FULL		1000					// sched_load() at 100%
+#define SCHED_REPORT_PERIOD	(SCHED_HZ(1) * 5)		// 5s
+
+typedef struct {
+	const char* name;
+	void (*run)(void);
+	alt_u32 rel_deadline;					// cycles after the release
+	alt_u32 ready;							// released or waiting for the release time
+	deadline_timer release;					// next release, period 0 = on demand
+	alt_u32 deadline;						// absolute deadline of the next run
+	alt_u32 runs, late, max;
+	alt_u64 sum;							// cycles spent in run()
+} sched_task;
+
+void sched_init(void);
+void sched_add(sched_task* task, const char* name, void (*run)(void),
+               alt_u32 period, alt_u32 rel_deadline);
+void sched_wake(sched_task* task, alt_u32 delay);
+int  sched_run(void);
+void sched_report(void);
+alt_u32 sched_load(void);
+alt_u32 sched_load_peak(void);
+
+#endif /* SCHED_H_ */
@@ -0,0 +1,162 @@
+#include <stddef.h>
+#include <altera_avalon_pio_regs.h>
+#include <sys/alt_irq.h>
+#include <system.h>
+#include "cycles.h"
+#include "fixmath.h"
+#include "hbridge.h"
+#include "prof.h"
+#include "pwm.h"
+#include "speed.h"
+
+/*------------------------------------------------/
+ Name:				variables
+ Description: speed_edge/speed_period are written
+ 	 	 	  by the tachometer ISR only
+ ------------------------------------------------*/
+
+static volatile alt_u32 speed_edge, speed_period;
+static alt_u32 speed_target;						// rpm, 0 = off
+static alt_u32 speed_measured;						// rpm at the last step
+static alt_32  speed_integ;							// Q8 1/65536 duty
+static alt_u32 speed_out;							// 1/65536 duty last set
+
+/*------------------------------------------------/
+ Name:				speed_tach_isr
+ Description: one tachometer pulse: keep the time
+ 	 	 	  since the previous one
+ ------------------------------------------------*/
+
+static void speed_tach_isr(void* context)
+{
+	alt_u32 now = cycles_now();
+
+	IOWR_ALTERA_AVALON_PIO_EDGE_CAP(SPEED_TACH_BASE, 0);
+	speed_period = now - speed_edge;
+	speed_edge = now;
+}
+
+/*------------------------------------------------/
+ Name:				speed_init
+ Description: register the tachometer interrupt,
+ 	 	 	  cycles_now() must already run
+ ------------------------------------------------*/
+
+void speed_init(void)
+{
+	speed_target = 0;
+	speed_integ = 0;
+	speed_period = 0;
+	speed_edge = cycles_now() - SPEED_STALL_CYCLES;
+
+	IOWR_ALTERA_AVALON_PIO_EDGE_CAP(SPEED_TACH_BASE, 0);
+	alt_ic_isr_register(SPEED_TACH_IRQ_IC, SPEED_TACH_IRQ, speed_tach_isr, NULL, NULL);
+	IOWR_ALTERA_AVALON_PIO_IRQ_MASK(SPEED_TACH_BASE, 1);
+}
+
+/*------------------------------------------------/
+ Name:				speed_set
+ Description: new set point in percent of
+ 	 	 	  SPEED_MAX_RPM, 0 stops the motor
+ ------------------------------------------------*/
+
+void speed_set(alt_u32 percent)
+{
+	if (percent > 100) percent = 100;
+
+#if SPEED_CLOSED_LOOP
+	if (percent * SPEED_RPM_STEP == speed_target) return;
+
+	if (percent == 0) {
+		hbridge_set(SPEED_CHANNEL, HBRIDGE_COAST);
+		speed_integ = 0;
+		speed_out = 0;
+	} else if (speed_target == 0) {
+		pwm_set_duty16(SPEED_CHANNEL, 0);
+		hbridge_set(SPEED_CHANNEL, HBRIDGE_FORWARD);
+		pwm_start();
+	}
+	speed_target = percent * SPEED_RPM_STEP;
+#else
+	speed_out = (percent * FIX_RECIP(100, 24)) >> 8;	// percent * 65536 / 100
+	if (percent == 0) {
+		hbridge_set(SPEED_CHANNEL, HBRIDGE_COAST);
+	} else {
+		pwm_set_duty(SPEED_CHANNEL, percent);
+		hbridge_set(SPEED_CHANNEL, HBRIDGE_FORWARD);
+		pwm_start();
+	}
+#endif
+}
+
+/*------------------------------------------------/
+ Name:				speed_step
+ Description: one PI step, run by the scheduler
+ 	 	 	  every SPEED_CTRL_CYCLES
+ ------------------------------------------------*/
+
+void speed_step(void)
+{
+	alt_u32 now, edge, period;
+	alt_32 error, out, integ;
+	alt_irq_context context;
+
+	PROF_ENTER(PROF_SPEED);
+
+	context = alt_irq_disable_all();
+	now = cycles_now();
+	edge = speed_edge;
+	period = speed_period;
+	alt_irq_enable_all(context);
+
+	if (period == 0 || now - edge >= SPEED_STALL_CYCLES)
+		speed_measured = 0;
+	else
+		speed_measured = SPEED_RPM_K / period;		// the one divide per step
+
+	if (speed_target == 0) {
+		PROF_EXIT(PROF_SPEED);
+		return;
+	}
+
+	error = (alt_32)speed_target - (alt_32)speed_measured;
+	integ = speed_integ + SPEED_KI_Q8 * error;
+	if (integ < 0) integ = 0;
+	if (integ > (alt_32)PWM_DUTY16_FULL << 8) integ = (alt_32)PWM_DUTY16_FULL << 8;
+
+	out = (SPEED_KP_Q8 * error + integ) >> 8;
+	if (out > (alt_32)PWM_DUTY16_FULL) {
+		out = PWM_DUTY16_FULL;
+		if (error < 0) speed_integ = integ;			// only unwind while saturated high
+	} else if (out < 0) {
+		out = 0;
+		if (error > 0) speed_integ = integ;
+	} else {
+		speed_integ = integ;
+	}
+
+	speed_out = out;
+	pwm_set_duty16(SPEED_CHANNEL, out);
+	PROF_EXIT(PROF_SPEED);
+}
+
+/*------------------------------------------------/
+ Name:				speed_rpm
+ Description: speed seen at the last control step
+ ------------------------------------------------*/
+
+alt_u32 speed_rpm(void)
+{
+	return speed_measured;
+}
+
+/*------------------------------------------------/
+ Name:				speed_duty16
+ Description: duty cycle of the motor channel in
+ 	 	 	  1/65536 (PWM_DUTY16_FULL = 100%)
+ ------------------------------------------------*/
+
+alt_u32 speed_duty16(void)
+{
+	return speed_out;
+}
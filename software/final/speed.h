@@ -0,0 +1,54 @@
+#ifndef SPEED_H_
+#define SPEED_H_
+
+#include <alt_types.h>
+#include <system.h>
+#include "cycles.h"
+#include "hbridge.h"
+
+/*###################################################
+ 	 	 	 	 SPEED CONTROL
+- Feedback: tachometer on GPIO[5] (TACH PIO, rising
+  edge IRQ 5). The ISR keeps the timestamp distance
+  between the last two pulses
+- speed_step() is the PI step, the scheduler runs it
+  every SPEED_CTRL_CYCLES (1kHz). It writes the duty of H-bridge
+  channel A with pwm_set_duty16(), so the gains do
+  not depend on the PWM frequency
+- PI in Q8 fixed point, integral clamped to the duty
+  range and frozen while the output is saturated in
+  the direction of the error (anti-windup)
+- SPEED_CLOSED_LOOP 0: speed_set() just sets the
+  duty cycle, as before the tachometer was fitted
+###################################################*/
+
+#ifndef SPEED_CLOSED_LOOP
+#define SPEED_CLOSED_LOOP	1
+#endif
+
+#define SPEED_CHANNEL		HBRIDGE_A					// motor with the tachometer
+#define SPEED_TACH_BASE		TACH_BASE
+#define SPEED_TACH_IRQ		TACH_IRQ
+#define SPEED_TACH_IRQ_IC	TACH_IRQ_INTERRUPT_CONTROLLER_ID
+#define SPEED_TACH_PPR		12							// pulses per revolution
+#define SPEED_CLK			CYCLES_CLK
+
+/* rpm = SPEED_RPM_K / pulse period in clock cycles */
+#define SPEED_RPM_K			(SPEED_CLK / SPEED_TACH_PPR * 60)
+
+#define SPEED_MAX_RPM		3000						// set point for 100%
+#define SPEED_RPM_STEP		(SPEED_MAX_RPM / 100)		// rpm per 1%
+#define SPEED_CTRL_CYCLES	(SPEED_CLK / 1000)			// 1kHz control rate
+#define SPEED_STALL_CYCLES	(SPEED_CLK / 20)			// no pulse for 50ms = stopped
+
+/* gains in 1/65536 duty per rpm of error, Q8 */
+#define SPEED_KP_Q8			13422						// 52.4/rpm (40 cycles at 1kHz)
+#define SPEED_KI_Q8			503							// 1.97/rpm per step (1.5 cycles at 1kHz)
+
+void    speed_init(void);
+void    speed_set(alt_u32 percent);
+void    speed_step(void);
+alt_u32 speed_rpm(void);
+alt_u32 speed_duty16(void);
+
+#endif /* SPEED_H_ */
@@ -0,0 +1,124 @@
+#include <stddef.h>
+#include <altera_avalon_pio_regs.h>
+#include <sys/alt_alarm.h>
+#include <sys/alt_irq.h>
+#include <system.h>
+#include "switch.h"
+
+/*------------------------------------------------/
+ Name:				variables
+ Description: event ring. switch_head is only
+ 	 	 	  written by the producer, switch_tail
+ 	 	 	  only by the consumer
+ ------------------------------------------------*/
+
+static volatile switch_event switch_queue[SWITCH_QUEUE_SIZE];
+static volatile alt_u32 switch_head, switch_tail;
+static alt_u32 switch_stable;						// last state put in the queue
+static alt_alarm switch_alarm;
+
+/*------------------------------------------------/
+ Name:				switch_push
+ Description: add an event, returns 0 and stores
+ 	 	 	  nothing if the queue is full
+ ------------------------------------------------*/
+
+static int switch_push(alt_u32 state, alt_u32 changed)
+{
+	alt_u32 head = switch_head;
+	volatile switch_event* event;
+
+	if (head - switch_tail >= SWITCH_QUEUE_SIZE) return 0;
+
+	event = &switch_queue[head & (SWITCH_QUEUE_SIZE - 1)];
+	event->state   = state;
+	event->changed = changed;
+	event->time    = alt_nticks();
+	switch_head = head + 1;							// publish after the slot is filled
+	return 1;
+}
+
+/*------------------------------------------------/
+ Name:				switch_settle
+ Description: debounce alarm. Any edge during the
+ 	 	 	  last window restarts it, otherwise the
+ 	 	 	  inputs are sampled and the IRQ unmasked.
+ 	 	 	  With the queue full switch_stable is
+ 	 	 	  kept and the sample retried a window
+ 	 	 	  later, so no changed bit is lost
+ ------------------------------------------------*/
+
+static alt_u32 switch_settle(void* context)
+{
+	alt_u32 edges, state;
+
+	edges = IORD_ALTERA_AVALON_PIO_EDGE_CAP(SWITCH_PIO_BASE);
+	if (edges) {
+		IOWR_ALTERA_AVALON_PIO_EDGE_CAP(SWITCH_PIO_BASE, edges);
+		return SWITCH_DEBOUNCE_TICKS;				// still bouncing
+	}
+
+	state = IORD_ALTERA_AVALON_PIO_DATA(SWITCH_PIO_BASE) & SWITCH_ALL;
+	if (state != switch_stable) {
+		if (!switch_push(state, state ^ switch_stable))
+			return SWITCH_DEBOUNCE_TICKS;			// queue full, IRQ stays masked
+		switch_stable = state;
+	}
+
+	IOWR_ALTERA_AVALON_PIO_IRQ_MASK(SWITCH_PIO_BASE, SWITCH_ALL);
+	return 0;
+}
+
+/*------------------------------------------------/
+ Name:				switch_isr
+ Description: first edge of a burst: mask the IRQ
+ 	 	 	  and let the alarm do the rest
+ ------------------------------------------------*/
+
+static void switch_isr(void* context)
+{
+	IOWR_ALTERA_AVALON_PIO_IRQ_MASK(SWITCH_PIO_BASE, 0);
+	IOWR_ALTERA_AVALON_PIO_EDGE_CAP(SWITCH_PIO_BASE, SWITCH_ALL);
+	alt_alarm_start(&switch_alarm, SWITCH_DEBOUNCE_TICKS, switch_settle, NULL);
+}
+
+/*------------------------------------------------/
+ Name:				switch_init
+ Description: queue the power-on state as the
+ 	 	 	  first event and enable edge interrupts
+ ------------------------------------------------*/
+
+void switch_init(void)
+{
+	switch_head = switch_tail = 0;
+
+	IOWR_ALTERA_AVALON_PIO_IRQ_MASK(SWITCH_PIO_BASE, 0);
+	IOWR_ALTERA_AVALON_PIO_EDGE_CAP(SWITCH_PIO_BASE, SWITCH_ALL);
+
+	switch_stable = IORD_ALTERA_AVALON_PIO_DATA(SWITCH_PIO_BASE) & SWITCH_ALL;
+	switch_push(switch_stable, SWITCH_ALL);
+
+	alt_ic_isr_register(SWITCH_PIO_IRQ_IC, SWITCH_PIO_IRQ, switch_isr, NULL, NULL);
+	IOWR_ALTERA_AVALON_PIO_IRQ_MASK(SWITCH_PIO_BASE, SWITCH_ALL);
+}
+
+/*------------------------------------------------/
+ Name:				switch_get
+ Description: take the oldest event, returns 0
+ 	 	 	  when there is none
+ ------------------------------------------------*/
+
+int switch_get(switch_event* event)
+{
+	alt_u32 tail = switch_tail;
+	volatile switch_event* slot;
+
+	if (tail == switch_head) return 0;
+
+	slot = &switch_queue[tail & (SWITCH_QUEUE_SIZE - 1)];
+	event->state   = slot->state;
+	event->changed = slot->changed;
+	event->time    = slot->time;
+	switch_tail = tail + 1;							// release the slot after the copy
+	return 1;
+}
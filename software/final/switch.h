@@ -0,0 +1,36 @@
+#ifndef SWITCH_H_
+#define SWITCH_H_
+
+#include <alt_types.h>
+#include <system.h>
+
+/*###################################################
+ 	 	 	 	 SWITCH INPUT
+- PIO: SWITCH_BASE, edge capture on ANY edge, IRQ 4
+- An edge masks the switch IRQ and arms a debounce
+  alarm. When the edge register has stayed clear for
+  SWITCH_DEBOUNCE_TICKS the inputs are sampled once
+  and, if the stable state changed, an event is put
+  in the queue
+- Queue: single producer (alarm callback, interrupt
+  context) / single consumer (main loop), lock-free
+###################################################*/
+
+#define SWITCH_PIO_BASE			SWITCH_BASE
+#define SWITCH_PIO_IRQ			SWITCH_IRQ
+#define SWITCH_PIO_IRQ_IC		SWITCH_IRQ_INTERRUPT_CONTROLLER_ID
+#define SWITCH_ALL				((1 << SWITCH_DATA_WIDTH) - 1)
+
+#define SWITCH_DEBOUNCE_TICKS	20			// system clock ticks (1 ms each)
+#define SWITCH_QUEUE_SIZE		16			// power of 2
+
+typedef struct {
+	alt_u32 state;							// debounced level of SW9..SW0
+	alt_u32 changed;						// bits that differ from the previous event
+	alt_u32 time;							// alt_nticks() when it was sampled
+} switch_event;
+
+void switch_init(void);
+int  switch_get(switch_event* event);
+
+#endif /* SWITCH_H_ */
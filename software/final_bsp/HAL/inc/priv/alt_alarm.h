@@ -66,8 +66,8 @@ struct alt_alarm_s
                           * zero indicates that the alarm should be removed 
                           * from the list. 
                           */
-  alt_u8 rollover;       /* set when desired alarm time + current time causes
-                            overflow, to prevent premature alarm */
+  alt_u8 rollover;       /* set by alt_tick() while the callback runs, cleared
+                            if the callback stops or restarts the alarm */
   void* context;         /* Argument for the callback */
 };
 
@@ -90,9 +90,38 @@ extern alt_u32 _alt_tick_rate;
 
 extern volatile alt_u32 _alt_nticks;
 
-/* The list of registered alarms. */
+/*
+ * The registered alarms, hashed by expiry tick into ALT_ALARM_WHEEL_SIZE
+ * slots (a power of two). alt_alarm_insert() must be called with interrupts
+ * disabled.
+ */
+
+#define ALT_ALARM_WHEEL_SIZE 256
+
+extern alt_llist alt_alarm_wheel[ALT_ALARM_WHEEL_SIZE];
+
+extern void alt_alarm_insert (struct alt_alarm_s* alarm);
+
+/*
+ * alt_alarm_next() returns the number of ticks from _alt_nticks to the
+ * earliest registered alarm (at least one), or zero if there is none. It
+ * looks at the head of every slot, so it is for a tickless system clock
+ * choosing its next interrupt. Must be called with interrupts disabled.
+ */
+
+extern alt_u32 alt_alarm_next (void);
+
+/*
+ * A tickless system clock driver does not interrupt on every tick. It sets
+ * "_alt_tick_sync" to a function that brings _alt_nticks up to date from its
+ * counter, and "_alt_tick_arm" to one that makes it interrupt no later than
+ * the start of tick "time"; alt_alarm_start() calls it, with interrupts
+ * disabled, for every alarm it registers. Both are null for a periodic
+ * system clock.
+ */
 
-extern alt_llist alt_alarm_list;
+extern void (*_alt_tick_sync) (void);
+extern void (*_alt_tick_arm) (alt_u32 time);
 
 #ifdef __cplusplus
 }
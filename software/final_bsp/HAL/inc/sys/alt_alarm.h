@@ -105,10 +105,15 @@ static ALT_INLINE int ALT_ALWAYS_INLINE alt_sysclk_init (alt_u32 nticks)
 
 /*
  * alt_nticks() returns the elapsed number of system clock ticks since reset.
+ * A tickless system clock brings the count up to date first.
  */
 
 static ALT_INLINE alt_u32 ALT_ALWAYS_INLINE alt_nticks (void)
 {
+  if (_alt_tick_sync)
+  {
+    _alt_tick_sync ();
+  }
   return _alt_nticks;
 }
 
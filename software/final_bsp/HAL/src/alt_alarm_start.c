@@ -82,20 +82,21 @@ int alt_alarm_start (alt_alarm* alarm, alt_u32 nticks,
       alarm->time = nticks + current_nticks + 1; 
       
       /* 
-       * If the desired alarm time causes a roll-over, set the rollover
-       * flag. This will prevent the subsequent tick event from causing
-       * an alarm too early.
+       * The wheel compares for equality against the tick counter, so a
+       * roll-over of the alarm time needs no special handling. "rollover"
+       * is only set by alt_tick() while the callback is running.
        */
-      if(alarm->time < current_nticks)
-      {
-        alarm->rollover = 1;
-      }
-      else
+      alarm->rollover = 0;
+    
+      alt_alarm_insert (alarm);
+
+      /* a tickless system clock may be asleep past the new alarm */
+
+      if (_alt_tick_arm)
       {
-        alarm->rollover = 0;
+        _alt_tick_arm (alarm->time);
       }
-    
-      alt_llist_insert (&alt_alarm_list, &alarm->llist);
+
       alt_irq_enable_all (irq_context);
 
       return 0;
@@ -30,6 +30,8 @@
 * file be used in conjunction or combination with any other product.          *
 ******************************************************************************/
 
+#include <stddef.h>
+
 #include "sys/alt_irq.h"
 #include "sys/alt_alarm.h"
 #include "os/alt_hooks.h"
@@ -51,11 +53,103 @@ alt_u32 _alt_tick_rate = 0;
 volatile alt_u32 _alt_nticks = 0;
 
 /*
- * "alt_alarm_list" is the head of a linked list of registered alarms. This is
- * initialised to be an empty list.
+ * "_alt_tick_sync" and "_alt_tick_arm" are set by a tickless system clock
+ * driver, see priv/alt_alarm.h.
+ */
+
+void (*_alt_tick_sync) (void) = NULL;
+void (*_alt_tick_arm) (alt_u32 time) = NULL;
+
+/*
+ * "alt_alarm_wheel" holds the registered alarms hashed by expiry time: an
+ * alarm due at tick "t" is kept in slot (t & (ALT_ALARM_WHEEL_SIZE - 1)),
+ * and each slot is sorted by distance from the current tick. alt_tick()
+ * therefore only looks at the head of one slot per tick, however many
+ * alarms are registered. The slots are set up on first use.
  */
 
-ALT_LLIST_HEAD(alt_alarm_list);
+alt_llist alt_alarm_wheel[ALT_ALARM_WHEEL_SIZE];
+static alt_u8 alt_alarm_wheel_ready = 0;
+
+/*
+ * alt_alarm_insert() links an alarm into the slot for alarm->time, after
+ * every alarm in that slot that is due no later than it. Must be called with
+ * interrupts disabled.
+ */
+
+void alt_alarm_insert (alt_alarm* alarm)
+{
+  alt_llist* slot;
+  alt_llist* pos;
+  alt_32     distance;
+  int        i;
+
+  if (!alt_alarm_wheel_ready)
+  {
+    for (i = 0; i < ALT_ALARM_WHEEL_SIZE; i++)
+    {
+      alt_alarm_wheel[i].next     = &alt_alarm_wheel[i];
+      alt_alarm_wheel[i].previous = &alt_alarm_wheel[i];
+    }
+    alt_alarm_wheel_ready = 1;
+  }
+
+  slot     = &alt_alarm_wheel[alarm->time & (ALT_ALARM_WHEEL_SIZE - 1)];
+  distance = (alt_32) (alarm->time - _alt_nticks);
+
+  /*
+   * Alarms in the same slot are a multiple of ALT_ALARM_WHEEL_SIZE ticks
+   * apart; comparing distances rather than times keeps the order correct
+   * across a wrap of _alt_nticks.
+   */
+
+  for (pos = slot; pos->next != slot; pos = pos->next)
+  {
+    if ((alt_32) (((alt_alarm*) pos->next)->time - _alt_nticks) > distance)
+    {
+      break;
+    }
+  }
+
+  alt_llist_insert (pos, &alarm->llist);
+}
+
+/*
+ * alt_alarm_next() returns the distance to the earliest alarm. Each slot is
+ * sorted by distance, so only the slot heads need to be compared.
+ */
+
+alt_u32 alt_alarm_next (void)
+{
+  alt_llist* slot;
+  alt_32     distance;
+  alt_32     next = 0;
+  int        i;
+
+  if (!alt_alarm_wheel_ready)
+  {
+    return 0;
+  }
+
+  for (i = 0; i < ALT_ALARM_WHEEL_SIZE; i++)
+  {
+    slot = &alt_alarm_wheel[i];
+    if (slot->next != slot)
+    {
+      distance = (alt_32) (((alt_alarm*) slot->next)->time - _alt_nticks);
+      if (distance < 1)
+      {
+        distance = 1;
+      }
+      if (!next || distance < next)
+      {
+        next = distance;
+      }
+    }
+  }
+
+  return next;
+}
 
 /*
  * alt_alarm_stop() is called to remove an alarm from the list of registered 
@@ -69,6 +163,7 @@ void alt_alarm_stop (alt_alarm* alarm)
 
   irq_context = alt_irq_disable_all();
   alt_llist_remove (&alarm->llist);
+  alarm->rollover = 0;
   alt_irq_enable_all (irq_context);
 }
 
@@ -81,13 +176,16 @@ void alt_alarm_stop (alt_alarm* alarm)
  * elapse until the next callback. A return value of zero indicates that the
  * alarm should be deactivated. 
  * 
+ * Only the slot for the new tick is examined, and only while its head is due,
+ * so the cost is proportional to the number of alarms that expire.
+ *
  * alt_tick() is expected to run at interrupt level.
  */
 
 void alt_tick (void)
 {
-  alt_alarm* next;
-  alt_alarm* alarm = (alt_alarm*) alt_alarm_list.next;
+  alt_llist* slot;
+  alt_alarm* alarm;
 
   alt_u32    next_callback;
 
@@ -95,49 +193,42 @@ void alt_tick (void)
 
   _alt_nticks++;
 
-  /* process the registered callbacks */
+  /* process the callbacks that are due now */
 
-  while (alarm != (alt_alarm*) &alt_alarm_list)
+  if (alt_alarm_wheel_ready)
   {
-    next = (alt_alarm*) alarm->llist.next;
-
-    /* 
-     * Upon the tick-counter rolling over it is safe to clear the 
-     * roll-over flag; once the flag is cleared this (or subsequnt)
-     * tick events are enabled to generate an alarm event. 
-     */
-    if ((alarm->rollover) && (_alt_nticks == 0))
-    {
-      alarm->rollover = 0;
-    }
-    
-    /* if the alarm period has expired, make the callback */    
-    if ((alarm->time <= _alt_nticks) && (alarm->rollover == 0))
+    slot = &alt_alarm_wheel[_alt_nticks & (ALT_ALARM_WHEEL_SIZE - 1)];
+
+    while ((slot->next != slot) &&
+           (((alt_alarm*) slot->next)->time == _alt_nticks))
     {
-      next_callback = alarm->callback (alarm->context);
+      alarm = (alt_alarm*) slot->next;
 
-      /* deactivate the alarm if the return value is zero */
+      /*
+       * Unlink before the callback, and mark the alarm as running. The
+       * callback may stop the alarm (which clears the mark) or restart it
+       * with alt_alarm_start(); either way its own choice wins over the
+       * return value.
+       */
 
-      if (next_callback == 0)
-      {
-        alt_alarm_stop (alarm);
-      }
-      else
+      alt_llist_remove (&alarm->llist);
+      alarm->rollover = 1;
+
+      next_callback = alarm->callback (alarm->context);
+
+      if (alarm->rollover)
       {
-        alarm->time += next_callback;
-        
-        /* 
-         * If the desired alarm time causes a roll-over, set the rollover
-         * flag. This will prevent the subsequent tick event from causing
-         * an alarm too early.
-         */
-        if(alarm->time < _alt_nticks)
+        alarm->rollover = 0;
+
+        /* deactivate the alarm if the return value is zero */
+
+        if (next_callback != 0)
         {
-          alarm->rollover = 1;
+          alarm->time += next_callback;
+          alt_alarm_insert (alarm);
         }
       }
     }
-    alarm = next;
   }
 
   /* 
@@ -146,4 +237,3 @@ void alt_tick (void)
 
   ALT_OS_TIME_TICK();
 }
-
@@ -63,6 +63,25 @@ extern "C"
 #define alt_timestamp_type alt_u32
 #endif
 
+/*
+ * The system clock runs tickless when its timer has a writable period and a
+ * snapshot register, unless ALT_SYS_CLK_PERIODIC is defined: the timer is
+ * then programmed for the next alarm rather than interrupting every tick.
+ */
+
+#define __ALT_FIXED_PERIOD(name) name##_FIXED_PERIOD
+#define _ALT_FIXED_PERIOD(name) __ALT_FIXED_PERIOD(name)
+#define __ALT_SNAPSHOT(name) name##_SNAPSHOT
+#define _ALT_SNAPSHOT(name) __ALT_SNAPSHOT(name)
+
+#define ALT_SYS_CLK_FIXED_PERIOD _ALT_FIXED_PERIOD(ALT_SYS_CLK)
+#define ALT_SYS_CLK_SNAPSHOT _ALT_SNAPSHOT(ALT_SYS_CLK)
+
+#if !defined(ALT_SYS_CLK_PERIODIC) && (ALT_SYS_CLK_COUNTER_SIZE == 32) && \
+    !ALT_SYS_CLK_FIXED_PERIOD && ALT_SYS_CLK_SNAPSHOT
+#define ALT_SYS_CLK_TICKLESS
+#endif
+
 /*
  * The function alt_avalon_timer_sc_init() is the initialisation function for 
  * the system clock. It registers the timers interrupt handler, and then calls 
@@ -0,0 +1,20 @@
+#ifndef __CYCLE_COUNTER_REGS_H__
+#define __CYCLE_COUNTER_REGS_H__
+
+#include <io.h>
+
+/*
+ * cycle_counter register map (ip/cycle_counter/cycle_counter.v)
+ *
+ * COUNT and COUNT_HI are the low and high words of a 64-bit count of clock
+ * cycles since reset. Both are read only and reading has no side effects:
+ * a 64-bit value is COUNT_HI, COUNT, then COUNT_HI again until it matches.
+ */
+
+#define IOADDR_CYCLE_COUNTER_COUNT(base)        __IO_CALC_ADDRESS_NATIVE(base, 0)
+#define IORD_CYCLE_COUNTER_COUNT(base)          IORD(base, 0)
+
+#define IOADDR_CYCLE_COUNTER_COUNT_HI(base)     __IO_CALC_ADDRESS_NATIVE(base, 1)
+#define IORD_CYCLE_COUNTER_COUNT_HI(base)       IORD(base, 1)
+
+#endif /* __CYCLE_COUNTER_REGS_H__ */
@@ -0,0 +1,62 @@
+#ifndef __MOTOR_PWM_REGS_H__
+#define __MOTOR_PWM_REGS_H__
+
+#include <io.h>
+
+/*
+ * motor_pwm register map (ip/motor_pwm/motor_pwm.v)
+ *
+ * Two channels share the period. PERIOD, COMPARE (channel A), COMPARE_B
+ * and OUTPUT are latched by the core at the end of the running period.
+ * OUTPUT holds the pwm_out pattern for each channel level, the patterns
+ * of both channels are ORed. ENABLE bit 0 starts the counter and forces
+ * pwm_out low when cleared, ENABLE bit 1 (HOLD) keeps the running settings
+ * so that several writes are latched on the same period edge.
+ * DITHER/DITHER_B (16-bit fraction of a clock) are added to an accumulator
+ * at every period start, a carry makes that period's HIGH phase one clock
+ * longer.
+ */
+
+#define IOADDR_MOTOR_PWM_PERIOD(base)           __IO_CALC_ADDRESS_NATIVE(base, 0)
+#define IORD_MOTOR_PWM_PERIOD(base)             IORD(base, 0)
+#define IOWR_MOTOR_PWM_PERIOD(base, data)       IOWR(base, 0, data)
+
+#define IOADDR_MOTOR_PWM_COMPARE(base)          __IO_CALC_ADDRESS_NATIVE(base, 1)
+#define IORD_MOTOR_PWM_COMPARE(base)            IORD(base, 1)
+#define IOWR_MOTOR_PWM_COMPARE(base, data)      IOWR(base, 1, data)
+
+#define IOADDR_MOTOR_PWM_OUTPUT(base)           __IO_CALC_ADDRESS_NATIVE(base, 2)
+#define IORD_MOTOR_PWM_OUTPUT(base)             IORD(base, 2)
+#define IOWR_MOTOR_PWM_OUTPUT(base, data)       IOWR(base, 2, data)
+
+#define MOTOR_PWM_OUTPUT_MSK                    (0xFFFF)
+#define MOTOR_PWM_OUTPUT_A_HIGH_OFST            (0)
+#define MOTOR_PWM_OUTPUT_A_LOW_OFST             (4)
+#define MOTOR_PWM_OUTPUT_B_HIGH_OFST            (8)
+#define MOTOR_PWM_OUTPUT_B_LOW_OFST             (12)
+#define MOTOR_PWM_OUTPUT_CHANNEL_OFST           (8)     /* B - A */
+
+#define IOADDR_MOTOR_PWM_ENABLE(base)           __IO_CALC_ADDRESS_NATIVE(base, 3)
+#define IORD_MOTOR_PWM_ENABLE(base)             IORD(base, 3)
+#define IOWR_MOTOR_PWM_ENABLE(base, data)       IOWR(base, 3, data)
+
+#define MOTOR_PWM_ENABLE_MSK                    (0x1)
+#define MOTOR_PWM_ENABLE_OFST                   (0)
+#define MOTOR_PWM_ENABLE_HOLD_MSK               (0x2)
+#define MOTOR_PWM_ENABLE_HOLD_OFST              (1)
+
+#define IOADDR_MOTOR_PWM_COMPARE_B(base)        __IO_CALC_ADDRESS_NATIVE(base, 4)
+#define IORD_MOTOR_PWM_COMPARE_B(base)          IORD(base, 4)
+#define IOWR_MOTOR_PWM_COMPARE_B(base, data)    IOWR(base, 4, data)
+
+#define IOADDR_MOTOR_PWM_DITHER(base)           __IO_CALC_ADDRESS_NATIVE(base, 5)
+#define IORD_MOTOR_PWM_DITHER(base)             IORD(base, 5)
+#define IOWR_MOTOR_PWM_DITHER(base, data)       IOWR(base, 5, data)
+
+#define IOADDR_MOTOR_PWM_DITHER_B(base)         __IO_CALC_ADDRESS_NATIVE(base, 6)
+#define IORD_MOTOR_PWM_DITHER_B(base)           IORD(base, 6)
+#define IOWR_MOTOR_PWM_DITHER_B(base, data)     IOWR(base, 6, data)
+
+#define MOTOR_PWM_DITHER_MSK                    (0xFFFF)
+
+#endif /* __MOTOR_PWM_REGS_H__ */
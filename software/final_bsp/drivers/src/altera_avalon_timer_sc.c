@@ -41,6 +41,194 @@
 #include "alt_types.h"
 #include "sys/alt_log_printf.h"
 
+#ifdef ALT_SYS_CLK_TICKLESS
+
+/*
+ * Tickless system clock. The timer runs in continuous mode, but its period is
+ * rewritten on every interrupt so that it times out at the start of the tick
+ * of the next alarm ("due"). Between interrupts the tick count is worked out
+ * from the counter: it was (re)loaded "phase" clocks into tick "at", and each
+ * tick is "cycles" clocks. Rewriting the period stops the counter, so the
+ * clocks from the snapshot to the restart are estimated
+ * (ALT_SYSCLK_RESTART_CYCLES) and added to the phase; the tick count keeps in
+ * step with the timer clock to within that estimate per rewrite.
+ *
+ * A sleep is at most "max" ticks (65 seconds at 1 ms), and never shorter than
+ * half a tick: an alarm due sooner than that runs one tick late.
+ */
+
+#ifndef ALT_SYSCLK_RESTART_CYCLES
+#define ALT_SYSCLK_RESTART_CYCLES 120
+#endif
+
+static void*   alt_sysclk_base;
+static alt_u32 alt_sysclk_cycles;   /* counter clocks per tick */
+static alt_u32 alt_sysclk_max;      /* longest sleep in ticks */
+static alt_u32 alt_sysclk_period;   /* value in the period registers */
+static alt_u32 alt_sysclk_at;       /* tick the counter was (re)loaded in */
+static alt_u32 alt_sysclk_phase;    /* clocks into that tick at the (re)load */
+static alt_u32 alt_sysclk_due;      /* tick the counter times out at */
+static alt_u8  alt_sysclk_in_tick;  /* alarms are being processed */
+
+/*
+ * alt_sysclk_now() returns the current tick from a snapshot of the counter,
+ * and the clocks elapsed in it. The division is by shift and subtract, the
+ * quotient is below 2^16. Valid while the counter has not timed out since
+ * alt_sysclk_at was set.
+ */
+
+static alt_u32 alt_sysclk_now (alt_u32* sub)
+{
+  void*   base = alt_sysclk_base;
+  alt_u32 clocks, ticks = 0;
+  int     k;
+
+  IOWR_ALTERA_AVALON_TIMER_SNAPL (base, 0);
+  clocks = (IORD_ALTERA_AVALON_TIMER_SNAPL (base) & ALTERA_AVALON_TIMER_SNAPL_MSK) |
+           (IORD_ALTERA_AVALON_TIMER_SNAPH (base) & ALTERA_AVALON_TIMER_SNAPH_MSK) << 16;
+  clocks = alt_sysclk_period - clocks + alt_sysclk_phase;
+
+  for (k = 15; k >= 0; k--)
+  {
+    if ((clocks >> k) >= alt_sysclk_cycles)
+    {
+      clocks -= alt_sysclk_cycles << k;
+      ticks  |= 1 << k;
+    }
+  }
+
+  *sub = clocks;
+  return alt_sysclk_at + ticks;
+}
+
+/*
+ * alt_sysclk_program() sets the timer to time out at the start of tick
+ * "time". If it has timed out already the pending interrupt reprograms it.
+ * Must be called with interrupts disabled.
+ */
+
+static void alt_sysclk_program (alt_u32 time)
+{
+  void*   base = alt_sysclk_base;
+  alt_u32 now, sub, ticks, clocks;
+
+  now = alt_sysclk_now (&sub);
+  if (IORD_ALTERA_AVALON_TIMER_STATUS (base) & ALTERA_AVALON_TIMER_STATUS_TO_MSK)
+  {
+    return;
+  }
+
+  ticks = time - now;
+  if ((alt_32) ticks < 1)
+  {
+    ticks = 1;
+  }
+  else if (ticks > alt_sysclk_max)
+  {
+    ticks = alt_sysclk_max;
+  }
+
+  clocks = ticks * alt_sysclk_cycles - sub;
+  if (clocks < ALT_SYSCLK_RESTART_CYCLES + (alt_sysclk_cycles >> 1))
+  {
+    ticks++;
+    clocks += alt_sysclk_cycles;
+  }
+
+  /*
+   * Writing PERIODL stops the counter; a time out just before it was for
+   * this same tick, so its status is cleared too.
+   */
+
+  alt_sysclk_period = clocks - ALT_SYSCLK_RESTART_CYCLES - 1;
+  IOWR_ALTERA_AVALON_TIMER_PERIODL (base, alt_sysclk_period & ALTERA_AVALON_TIMER_PERIODL_MSK);
+  IOWR_ALTERA_AVALON_TIMER_STATUS (base, 0);
+  IOWR_ALTERA_AVALON_TIMER_PERIODH (base, alt_sysclk_period >> 16);
+  IOWR_ALTERA_AVALON_TIMER_CONTROL (base,
+            ALTERA_AVALON_TIMER_CONTROL_ITO_MSK  |
+            ALTERA_AVALON_TIMER_CONTROL_CONT_MSK |
+            ALTERA_AVALON_TIMER_CONTROL_START_MSK);
+
+  alt_sysclk_at    = now;
+  alt_sysclk_phase = sub + ALT_SYSCLK_RESTART_CYCLES;
+  alt_sysclk_due   = now + ticks;
+}
+
+/*
+ * alt_sysclk_tick() runs on a time out: the alarms of every tick up to now
+ * (normally just tick "due"), then the timer is set for the next alarm.
+ */
+
+static void alt_sysclk_tick (void)
+{
+  alt_u32 now, sub, next;
+
+  /* the counter reloaded at the start of tick "due" */
+
+  alt_sysclk_at    = alt_sysclk_due;
+  alt_sysclk_phase = 0;
+  now = alt_sysclk_now (&sub);
+
+  alt_sysclk_in_tick = 1;
+  _alt_nticks = alt_sysclk_due - 1;
+  while (_alt_nticks != now)
+  {
+    alt_tick ();
+  }
+  alt_sysclk_in_tick = 0;
+
+  next = alt_alarm_next ();
+  alt_sysclk_program (_alt_nticks + (next ? next : alt_sysclk_max));
+}
+
+/*
+ * alt_sysclk_sync() is _alt_tick_sync. While a time out is pending the count
+ * stops short of tick "due", the interrupt processes that tick.
+ */
+
+static void alt_sysclk_sync (void)
+{
+  void*           base = alt_sysclk_base;
+  alt_irq_context cpu_sr;
+  alt_u32         now, sub;
+
+  if (alt_sysclk_in_tick)
+  {
+    return;
+  }
+
+  cpu_sr = alt_irq_disable_all ();
+  if (IORD_ALTERA_AVALON_TIMER_STATUS (base) & ALTERA_AVALON_TIMER_STATUS_TO_MSK)
+  {
+    now = alt_sysclk_due - 1;
+  }
+  else
+  {
+    now = alt_sysclk_now (&sub);
+    if (IORD_ALTERA_AVALON_TIMER_STATUS (base) & ALTERA_AVALON_TIMER_STATUS_TO_MSK)
+    {
+      now = alt_sysclk_due - 1;
+    }
+  }
+  _alt_nticks = now;
+  alt_irq_enable_all (cpu_sr);
+}
+
+/*
+ * alt_sysclk_arm() is _alt_tick_arm: wake earlier for a new alarm. Alarms
+ * started from a callback are picked up when alt_sysclk_tick() reprograms.
+ */
+
+static void alt_sysclk_arm (alt_u32 time)
+{
+  if (!alt_sysclk_in_tick && (alt_32) (time - alt_sysclk_due) < 0)
+  {
+    alt_sysclk_program (time);
+  }
+}
+
+#endif /* ALT_SYS_CLK_TICKLESS */
+
 /* 
  * alt_avalon_timer_sc_irq() is the interrupt handler used for the system 
  * clock. This is called periodically when a timer interrupt occurs. The 
@@ -76,7 +264,11 @@ static void alt_avalon_timer_sc_irq (void* base, alt_u32 id)
    * during this time to safely support ISR preemption
    */
   cpu_sr = alt_irq_disable_all();
+#ifdef ALT_SYS_CLK_TICKLESS
+  alt_sysclk_tick ();
+#else
   alt_tick ();
+#endif
   alt_irq_enable_all(cpu_sr);
 }
 
@@ -92,6 +284,23 @@ void alt_avalon_timer_sc_init (void* base, alt_u32 irq_controller_id,
   /* set the system clock frequency */
   
   alt_sysclk_init (freq);
+
+#ifdef ALT_SYS_CLK_TICKLESS
+  /* the first time out is at the start of tick 1, as a periodic clock */
+
+  alt_sysclk_base   = base;
+  alt_sysclk_period = (IORD_ALTERA_AVALON_TIMER_PERIODL (base) & ALTERA_AVALON_TIMER_PERIODL_MSK) |
+                      (IORD_ALTERA_AVALON_TIMER_PERIODH (base) & ALTERA_AVALON_TIMER_PERIODH_MSK) << 16;
+  alt_sysclk_cycles = alt_sysclk_period + 1;
+  alt_sysclk_max    = 0xFFFFFFFF / alt_sysclk_cycles - 1;
+  if (alt_sysclk_max > 0xFFFE)
+  {
+    alt_sysclk_max = 0xFFFE;
+  }
+  alt_sysclk_at     = 0;
+  alt_sysclk_phase  = 0;
+  alt_sysclk_due    = 1;
+#endif
   
   /* set to free running mode */
   
@@ -107,4 +316,9 @@ void alt_avalon_timer_sc_init (void* base, alt_u32 irq_controller_id,
 #else
   alt_irq_register (irq, base, alt_avalon_timer_sc_irq);
 #endif  
+
+#ifdef ALT_SYS_CLK_TICKLESS
+  _alt_tick_sync = alt_sysclk_sync;
+  _alt_tick_arm  = alt_sysclk_arm;
+#endif
 }
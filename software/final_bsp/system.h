@@ -187,6 +187,10 @@
 #define __ALTERA_AVALON_SYSID_QSYS
 #define __ALTERA_AVALON_TIMER
 #define __ALTERA_NIOS2_GEN2
+#define __CYCLE_COUNTER
+#define __HEX_DISPLAY
+#define __LCD_REFRESH
+#define __MOTOR_PWM
 
 
 /*
@@ -195,9 +199,9 @@
  */
 
 #define ALT_MODULE_CLASS_LCD altera_avalon_pio
-#define LCD_BASE 0x4081070
+#define LCD_BASE 0x4081120
 #define LCD_BIT_CLEARING_EDGE_REGISTER 0
-#define LCD_BIT_MODIFYING_OUTPUT_REGISTER 0
+#define LCD_BIT_MODIFYING_OUTPUT_REGISTER 1
 #define LCD_CAPTURE 0
 #define LCD_DATA_WIDTH 11
 #define LCD_DO_TEST_BENCH_WIRING 0
@@ -205,14 +209,14 @@
 #define LCD_EDGE_TYPE "NONE"
 #define LCD_FREQ 50000000
 #define LCD_HAS_IN 0
-#define LCD_HAS_OUT 1
-#define LCD_HAS_TRI 0
+#define LCD_HAS_OUT 0
+#define LCD_HAS_TRI 1
 #define LCD_IRQ -1
 #define LCD_IRQ_INTERRUPT_CONTROLLER_ID -1
 #define LCD_IRQ_TYPE "NONE"
 #define LCD_NAME "/dev/LCD"
 #define LCD_RESET_VALUE 0
-#define LCD_SPAN 16
+#define LCD_SPAN 32
 #define LCD_TYPE "altera_avalon_pio"
 
 
@@ -278,9 +282,9 @@
  */
 
 #define ALT_MODULE_CLASS_MOTOR altera_avalon_pio
-#define MOTOR_BASE 0x4081040
+#define MOTOR_BASE 0x4081100
 #define MOTOR_BIT_CLEARING_EDGE_REGISTER 0
-#define MOTOR_BIT_MODIFYING_OUTPUT_REGISTER 0
+#define MOTOR_BIT_MODIFYING_OUTPUT_REGISTER 1
 #define MOTOR_CAPTURE 0
 #define MOTOR_DATA_WIDTH 4
 #define MOTOR_DO_TEST_BENCH_WIRING 0
@@ -295,7 +299,7 @@
 #define MOTOR_IRQ_TYPE "NONE"
 #define MOTOR_NAME "/dev/MOTOR"
 #define MOTOR_RESET_VALUE 0
-#define MOTOR_SPAN 16
+#define MOTOR_SPAN 32
 #define MOTOR_TYPE "altera_avalon_pio"
 
 
@@ -306,26 +310,53 @@
 
 #define ALT_MODULE_CLASS_SWITCH altera_avalon_pio
 #define SWITCH_BASE 0x4081050
-#define SWITCH_BIT_CLEARING_EDGE_REGISTER 0
+#define SWITCH_BIT_CLEARING_EDGE_REGISTER 1
 #define SWITCH_BIT_MODIFYING_OUTPUT_REGISTER 0
-#define SWITCH_CAPTURE 0
+#define SWITCH_CAPTURE 1
 #define SWITCH_DATA_WIDTH 10
 #define SWITCH_DO_TEST_BENCH_WIRING 0
 #define SWITCH_DRIVEN_SIM_VALUE 0
-#define SWITCH_EDGE_TYPE "NONE"
+#define SWITCH_EDGE_TYPE "ANY"
 #define SWITCH_FREQ 50000000
 #define SWITCH_HAS_IN 1
 #define SWITCH_HAS_OUT 0
 #define SWITCH_HAS_TRI 0
-#define SWITCH_IRQ -1
-#define SWITCH_IRQ_INTERRUPT_CONTROLLER_ID -1
-#define SWITCH_IRQ_TYPE "NONE"
+#define SWITCH_IRQ 4
+#define SWITCH_IRQ_INTERRUPT_CONTROLLER_ID 0
+#define SWITCH_IRQ_TYPE "EDGE"
 #define SWITCH_NAME "/dev/SWITCH"
 #define SWITCH_RESET_VALUE 0
 #define SWITCH_SPAN 16
 #define SWITCH_TYPE "altera_avalon_pio"
 
 
+/*
+ * TACH configuration
+ *
+ */
+
+#define ALT_MODULE_CLASS_TACH altera_avalon_pio
+#define TACH_BASE 0x40810d0
+#define TACH_BIT_CLEARING_EDGE_REGISTER 0
+#define TACH_BIT_MODIFYING_OUTPUT_REGISTER 0
+#define TACH_CAPTURE 1
+#define TACH_DATA_WIDTH 1
+#define TACH_DO_TEST_BENCH_WIRING 0
+#define TACH_DRIVEN_SIM_VALUE 0
+#define TACH_EDGE_TYPE "RISING"
+#define TACH_FREQ 50000000
+#define TACH_HAS_IN 1
+#define TACH_HAS_OUT 0
+#define TACH_HAS_TRI 0
+#define TACH_IRQ 5
+#define TACH_IRQ_INTERRUPT_CONTROLLER_ID 0
+#define TACH_IRQ_TYPE "EDGE"
+#define TACH_NAME "/dev/TACH"
+#define TACH_RESET_VALUE 0
+#define TACH_SPAN 16
+#define TACH_TYPE "altera_avalon_pio"
+
+
 /*
  * System configuration
  *
@@ -373,6 +404,34 @@
 #define ALT_TIMESTAMP_CLK TIMER_1
 
 
+/*
+ * cycle_counter_0 configuration
+ *
+ */
+
+#define ALT_MODULE_CLASS_cycle_counter_0 cycle_counter
+#define CYCLE_COUNTER_0_BASE 0x4081040
+#define CYCLE_COUNTER_0_IRQ -1
+#define CYCLE_COUNTER_0_IRQ_INTERRUPT_CONTROLLER_ID -1
+#define CYCLE_COUNTER_0_NAME "/dev/cycle_counter_0"
+#define CYCLE_COUNTER_0_SPAN 8
+#define CYCLE_COUNTER_0_TYPE "cycle_counter"
+
+
+/*
+ * hex_display_0 configuration
+ *
+ */
+
+#define ALT_MODULE_CLASS_hex_display_0 hex_display
+#define HEX_DISPLAY_0_BASE 0x4081090
+#define HEX_DISPLAY_0_IRQ -1
+#define HEX_DISPLAY_0_IRQ_INTERRUPT_CONTROLLER_ID -1
+#define HEX_DISPLAY_0_NAME "/dev/hex_display_0"
+#define HEX_DISPLAY_0_SPAN 16
+#define HEX_DISPLAY_0_TYPE "hex_display"
+
+
 /*
  * jtag_uart_0 configuration
  *
@@ -391,6 +450,35 @@
 #define JTAG_UART_0_WRITE_THRESHOLD 8
 
 
+/*
+ * lcd_refresh_0 configuration
+ *
+ */
+
+#define ALT_MODULE_CLASS_lcd_refresh_0 lcd_refresh
+#define LCD_REFRESH_0_BASE 0x4081180
+#define LCD_REFRESH_0_CLK_FREQ 50000000
+#define LCD_REFRESH_0_IRQ -1
+#define LCD_REFRESH_0_IRQ_INTERRUPT_CONTROLLER_ID -1
+#define LCD_REFRESH_0_NAME "/dev/lcd_refresh_0"
+#define LCD_REFRESH_0_SPAN 128
+#define LCD_REFRESH_0_TYPE "lcd_refresh"
+
+
+/*
+ * motor_pwm_0 configuration
+ *
+ */
+
+#define ALT_MODULE_CLASS_motor_pwm_0 motor_pwm
+#define MOTOR_PWM_0_BASE 0x40810e0
+#define MOTOR_PWM_0_IRQ -1
+#define MOTOR_PWM_0_IRQ_INTERRUPT_CONTROLLER_ID -1
+#define MOTOR_PWM_0_NAME "/dev/motor_pwm_0"
+#define MOTOR_PWM_0_SPAN 32
+#define MOTOR_PWM_0_TYPE "motor_pwm"
+
+
 /*
  * sysid_qsys_0 configuration
  *
@@ -458,4 +546,30 @@
 #define TIMER_1_TIMEOUT_PULSE_OUTPUT 0
 #define TIMER_1_TYPE "altera_avalon_timer"
 
+
+/*
+ * timer_2 configuration
+ *
+ */
+
+#define ALT_MODULE_CLASS_timer_2 altera_avalon_timer
+#define TIMER_2_ALWAYS_RUN 0
+#define TIMER_2_BASE 0x40810a0
+#define TIMER_2_COUNTER_SIZE 32
+#define TIMER_2_FIXED_PERIOD 0
+#define TIMER_2_FREQ 50000000
+#define TIMER_2_IRQ 3
+#define TIMER_2_IRQ_INTERRUPT_CONTROLLER_ID 0
+#define TIMER_2_LOAD_VALUE 49999
+#define TIMER_2_MULT 0.001
+#define TIMER_2_NAME "/dev/timer_2"
+#define TIMER_2_PERIOD 1
+#define TIMER_2_PERIOD_UNITS "ms"
+#define TIMER_2_RESET_OUTPUT 0
+#define TIMER_2_SNAPSHOT 1
+#define TIMER_2_SPAN 32
+#define TIMER_2_TICKS_PER_SEC 1000
+#define TIMER_2_TIMEOUT_PULSE_OUTPUT 0
+#define TIMER_2_TYPE "altera_avalon_timer"
+
 #endif /* __SYSTEM_H_ */
@@ -0,0 +1,67 @@
+#include <stdio.h>
+#include "deadline.h"
+
+/*###################################################
+ 	 	 	 	 DEADLINE BOUNDARY CHECK
+- Runs software/final/deadline.h on the host (no
+  model needed) through fixed cases: on time, a
+  deadline exactly on now, checks more than a period
+  late and the 32-bit wrap
+- A deadline that falls exactly on now is due, not
+  skipped: deadline_poll() and deadline_advance()
+  must agree on it
+- Built by build-sim, prints every case, FAIL and
+  exit status 1 on a mismatch:
+	./build-sim && ./deadline_check
+###################################################*/
+
+static int check_failed;
+
+/*------------------------------------------------/
+ Name:				check_poll
+ Description: one deadline_poll() with the expected
+ 	 	 	  result, next deadline and overruns
+ ------------------------------------------------*/
+
+static void check_poll(const char* name, deadline_timer* d, alt_u32 now,
+		int due, alt_u32 next, alt_u32 overruns)
+{
+	int got = deadline_poll(d, now);
+	int bad = got != due || d->next != next || d->overruns != overruns;
+
+	printf("%-28s now 0x%08lx poll %d next 0x%08lx overruns %lu%s\n", name, (unsigned long)now,
+			got, (unsigned long)d->next, (unsigned long)d->overruns, bad ? "  FAIL" : "");
+	if (bad) check_failed = 1;
+}
+
+int main(void)
+{
+	deadline_timer d;
+
+	deadline_start(&d, 0, 100, 100);
+	check_poll("before", &d, 99, 0, 100, 0);
+	check_poll("on time", &d, 100, 1, 200, 0);
+
+	/* one period late: the next deadline is exactly now, so it is
+	 * still due and the following poll takes it */
+	check_poll("late, next on now", &d, 300, 1, 300, 0);
+	check_poll("deadline on now", &d, 300, 1, 400, 0);
+	check_poll("after", &d, 300, 0, 400, 0);
+
+	/* deadlines 400 and 500 passed, 600 is due: 500 skipped */
+	check_poll("late, next passed", &d, 600, 1, 600, 1);
+	check_poll("deadline on now", &d, 600, 1, 700, 1);
+
+	/* deadline 700 is due, 800 passed and is skipped, 900 ahead */
+	check_poll("late, skip one", &d, 850, 1, 900, 2);
+
+	/* across the 32-bit wrap */
+	deadline_start(&d, 0xFFFFFF00, 0x80, 0x100);
+	check_poll("wrap, on time", &d, 0xFFFFFF80, 1, 0x80, 0);
+	check_poll("wrap, before", &d, 0x7F, 0, 0x80, 0);
+	check_poll("wrap, late, next on now", &d, 0x180, 1, 0x180, 0);
+	check_poll("wrap, deadline on now", &d, 0x180, 1, 0x280, 0);
+
+	printf("%s\n", check_failed ? "FAIL" : "PASS");
+	return check_failed;
+}
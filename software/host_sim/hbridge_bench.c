@@ -0,0 +1,86 @@
+#include <stdio.h>
+#include "hbridge.h"
+#include "pwm.h"
+
+/*###################################################
+ 	 	 	 	 H-BRIDGE DEAD-TIME CHECK
+- Runs software/final/pwm.c and hbridge.c on the
+  simulator model (no application), channel A at
+  100% duty so the LOW phase hides no dead-time
+- At each PWM frequency reverses the channel from
+  BENCH_PHASES points spread over one period, three
+  ways: FORWARD -> REVERSE, FORWARD -> COAST ->
+  REVERSE and FORWARD -> BRAKE -> REVERSE (the
+  second request right after the first)
+- The model measures the undriven time on IN1/IN2
+  before every reversal; anything shorter than
+  HBRIDGE_DEADTIME_MS fails and the exit status is 1
+- Built by build-sim next to the simulator:
+	./build-sim && ./hbridge_bench
+	SIM_CFLAGS="-DPWM_USE_HW=0" ./build-sim && ./hbridge_bench
+###################################################*/
+
+#define BENCH_PHASES	8					// request points per period
+#define BENCH_SETTLE	(60 * 50000)		// cycles, 60ms: one reversal has landed
+#define BENCH_MIN_GAP	(HBRIDGE_DEADTIME_MS * 50000)
+
+static const alt_u32 bench_freq[] = { PWM_FREQ_MIN, 1000, 20000 };
+static const hbridge_mode bench_via[] = { HBRIDGE_FORWARD, HBRIDGE_COAST, HBRIDGE_BRAKE };
+static const char* const bench_via_name[] = { "direct", "coast", "brake" };
+
+/*------------------------------------------------/
+ Name:				bench_reverse
+ Description: FORWARD for a while, then from the
+ 	 	 	  given phase of the period to REVERSE
+ 	 	 	  (through via), returns the shortest
+ 	 	 	  undriven time before the reversal
+ ------------------------------------------------*/
+
+static alt_u64 bench_reverse(hbridge_mode via, alt_u32 phase)
+{
+	alt_u64 reversals, gap;
+
+	hbridge_set(HBRIDGE_A, HBRIDGE_FORWARD);
+	sim_advance(BENCH_SETTLE);
+	sim_reversal_sample(HBRIDGE_A, &reversals, &gap);
+
+	sim_advance(phase);
+	if (via != HBRIDGE_FORWARD) hbridge_set(HBRIDGE_A, via);
+	hbridge_set(HBRIDGE_A, HBRIDGE_REVERSE);
+	sim_advance(BENCH_SETTLE);
+	sim_reversal_sample(HBRIDGE_A, &reversals, &gap);
+	return reversals ? gap : 0;
+}
+
+int main(int argc, char* argv[])
+{
+	alt_u64 gap, worst;
+	unsigned int f, v, k;
+	int failed = 0;
+
+	sim_end = ~0ull;
+	pwm_init();
+	hbridge_init();
+	pwm_start();
+
+	printf("dead-time %d ms, %s backend\n", HBRIDGE_DEADTIME_MS, PWM_USE_HW ? "motor_pwm" : "timer_2");
+	printf("    freq       via   shortest dead-time us\n");
+
+	for (f = 0; f < sizeof(bench_freq) / sizeof(bench_freq[0]); f++) {
+		pwm_set_freq(bench_freq[f]);
+		pwm_set_duty16(HBRIDGE_A, PWM_DUTY16_FULL);
+		for (v = 0; v < sizeof(bench_via) / sizeof(bench_via[0]); v++) {
+			worst = ~0ull;
+			for (k = 0; k < BENCH_PHASES; k++) {
+				gap = bench_reverse(bench_via[v], k * pwm_get_period() / BENCH_PHASES);
+				if (gap < worst) worst = gap;
+			}
+			printf("%8lu  %8s   %21llu%s\n", (unsigned long)bench_freq[f], bench_via_name[v],
+					(unsigned long long)(worst / 50), worst < BENCH_MIN_GAP ? "  FAIL" : "");
+			if (worst < BENCH_MIN_GAP) failed = 1;
+		}
+	}
+
+	printf("%s\n", failed ? "FAIL" : "PASS");
+	return failed;
+}
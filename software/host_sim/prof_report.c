@@ -0,0 +1,97 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "prof.h"
+
+/*###################################################
+ 	 	 	 	 PROFILE REPORT
+- Reads the JTAG UART capture (file or stdin) and
+  prints the last complete profiler frame found in it
+- Built by build-sim next to the simulator:
+	nios2-terminal > capture.bin   (or the simulator)
+	./prof_report capture.bin
+###################################################*/
+
+#define PROF_FRAME_SIZE	(sizeof(prof_header) + PROF_REGIONS * sizeof(prof_record))
+
+/*------------------------------------------------/
+ Name:				prof_percentile
+ Description: upper bound in cycles of the bucket
+ 	 	 	  holding the given fraction of samples,
+ 	 	 	  limited to the recorded max
+ ------------------------------------------------*/
+
+static unsigned long prof_percentile(const prof_record* rec, double fraction)
+{
+	double want = rec->count * fraction;
+	double seen = 0;
+	int b;
+
+	for (b = 0; b < PROF_BUCKETS; b++) {
+		seen += rec->bucket[b];
+		if (seen >= want) break;
+	}
+	if (b >= PROF_BUCKETS - 1 || (1ul << b) - 1 > rec->max) return rec->max;
+	return b ? (1ul << b) - 1 : 0;
+}
+
+int main(int argc, char** argv)
+{
+	FILE* in = stdin;
+	unsigned char* data = NULL;
+	size_t size = 0, cap = 0, n, pos, frame = (size_t)-1;
+	const prof_header* header;
+	const prof_record* rec;
+	double loop_sum, us;
+	int i;
+
+	if (argc > 1 && !(in = fopen(argv[1], "rb"))) {
+		perror(argv[1]);
+		return 1;
+	}
+	do {
+		if (size == cap) data = realloc(data, cap = cap ? cap * 2 : 65536);
+		n = fread(data + size, 1, cap - size, in);
+		size += n;
+	} while (n);
+
+	for (pos = 0; pos + PROF_FRAME_SIZE <= size; pos++) {
+		alt_u32 magic;
+		memcpy(&magic, data + pos, sizeof(magic));
+		if (magic == PROF_MAGIC) frame = pos;
+	}
+	if (frame == (size_t)-1) {
+		fprintf(stderr, "prof_report: no complete frame in input\n");
+		return 1;
+	}
+
+	header = (const prof_header*)(data + frame);
+	rec = (const prof_record*)(header + 1);
+	if (header->regions != PROF_REGIONS || header->buckets != PROF_BUCKETS) {
+		fprintf(stderr, "prof_report: frame has %u regions/%u buckets, expected %u/%u\n",
+				header->regions, header->buckets, PROF_REGIONS, PROF_BUCKETS);
+		return 1;
+	}
+
+	us = 1e6 / header->freq;
+	loop_sum = rec[PROF_LOOP].sum_lo + rec[PROF_LOOP].sum_hi * 4294967296.0;
+
+	printf("%-12s %10s %9s %9s %9s %9s %9s %9s %6s\n",
+			"region", "count", "min us", "mean us", "p50 us", "p90 us", "p99 us", "max us", "%loop");
+	for (i = 0; i < PROF_REGIONS; i++) {
+		const prof_record* r = &rec[i];
+		double sum = r->sum_lo + r->sum_hi * 4294967296.0;
+
+		if (!r->count) {
+			printf("%-12.*s %10u\n", PROF_NAME_LEN, r->name, 0);
+			continue;
+		}
+		printf("%-12.*s %10lu %9.2f %9.2f %9.2f %9.2f %9.2f %9.2f %6.1f\n",
+				PROF_NAME_LEN, r->name, (unsigned long)r->count,
+				r->min * us, sum / r->count * us,
+				prof_percentile(r, 0.50) * us, prof_percentile(r, 0.90) * us,
+				prof_percentile(r, 0.99) * us, r->max * us,
+				loop_sum ? sum * 100 / loop_sum : 0);
+	}
+	return 0;
+}
@@ -0,0 +1,79 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "pwm.h"
+
+/*###################################################
+ 	 	 	 	 PWM RESOLUTION BENCHMARK
+- Runs software/final/pwm.c on the simulator model
+  (no application), channel A forward on IN1
+- For a few base duties, steps pwm_set_duty16()
+  through BENCH_STEPS consecutive values and measures
+  the average duty over BENCH_PERIODS periods each
+- The residual after removing the sweep's mean
+  offset (the software backend stretches every
+  period by its interrupt latency) is the step
+  error; effective bits = log2(65536 / (2 * max))
+- Built by build-sim next to the simulator, the
+  PWM frequency is set with pwm_set_freq():
+	./build-sim && ./pwm_bench 20000   (dithered)
+	SIM_CFLAGS="-DPWM_DITHER=0" ./build-sim
+	./pwm_bench 20000                  (HIGH count only)
+###################################################*/
+
+#define BENCH_STEPS		16					// consecutive duty values per sweep
+#define BENCH_PERIODS	256					// periods averaged per value
+
+static const alt_u32 bench_base[] = { 700, 3300, 16000, 40000 };	// 1%, 5%, 24%, 61%
+
+/*------------------------------------------------/
+ Name:				bench_measure
+ Description: average duty of channel A in 1/65536
+ 	 	 	  over BENCH_PERIODS after the new value
+ 	 	 	  has been taken over
+ ------------------------------------------------*/
+
+static double bench_measure(alt_u32 duty)
+{
+	alt_u64 high, period;
+
+	pwm_set_duty16(0, duty);
+	sim_advance(2 * pwm_get_period());
+	sim_pwm_sample(&high, &period);
+	sim_advance(BENCH_PERIODS * pwm_get_period());
+	sim_pwm_sample(&high, &period);
+	return period ? 65536.0 * high / period : 0;
+}
+
+int main(int argc, char* argv[])
+{
+	double m[BENCH_STEPS], offset, err, worst = 0;
+	unsigned int b, k;
+
+	sim_end = ~0ull;
+	pwm_init();
+	if (argc > 1) pwm_set_freq(strtoul(argv[1], NULL, 0));
+	pwm_set_pins(0, 1, 0);
+	pwm_start();
+
+	printf("PWM %lu Hz, %lu clocks/period (%.2f LSB16 per clock), %s, %s backend\n",
+			(unsigned long)pwm_get_freq(), (unsigned long)pwm_get_period(), 65536.0 / pwm_get_period(),
+			PWM_DITHER ? "dithered" : "no dither", PWM_USE_HW ? "motor_pwm" : "timer_2");
+	printf("base duty   offset LSB16   max step error LSB16\n");
+
+	for (b = 0; b < sizeof(bench_base) / sizeof(bench_base[0]); b++) {
+		offset = 0;
+		for (k = 0; k < BENCH_STEPS; k++) {
+			m[k] = bench_measure(bench_base[b] + k) - (bench_base[b] + k);
+			offset += m[k];
+		}
+		offset /= BENCH_STEPS;
+		for (err = 0, k = 0; k < BENCH_STEPS; k++)
+			if (fabs(m[k] - offset) > err) err = fabs(m[k] - offset);
+		if (err > worst) worst = err;
+		printf("%9lu   %12.2f   %20.3f\n", (unsigned long)bench_base[b], offset, err);
+	}
+
+	printf("effective resolution %.1f bits\n", log2(65536.0 / (2 * (worst > 1e-6 ? worst : 1e-6))));
+	return 0;
+}
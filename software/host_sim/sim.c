@@ -0,0 +1,1197 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <system.h>
+#include <nios2.h>
+#include <sys/alt_irq.h>
+#include <sys/alt_alarm.h>
+#include <altera_avalon_timer.h>
+#include <altera_avalon_timer_regs.h>
+#include <motor_pwm_regs.h>
+#include <lcd_refresh_regs.h>
+#include <hex_display_regs.h>
+#include <cycle_counter_regs.h>
+#include "sim_host.h"
+
+/*###################################################
+ 	 	 	 	 REGISTER-LEVEL MODEL
+- Every IORD/IOWR costs a fixed number of cycles
+  (sim_host.h) on a virtual 50MHz clock, so busy
+  loops and driver code cost deterministic time
+- Timers, PIOs and the JTAG UART are modelled at
+  register level from the values in system.h
+- LCD writes (LCD PIO pins or the bytes sent by
+  lcd_refresh_0) are decoded as an HD44780 and the
+  MOTOR PIO / motor_pwm_0 output (L298 IN1..IN4) is
+  measured as PWM
+- That output drives an L298 + DC motor model whose
+  tachometer pulses come back on the TACH PIO
+- Environment:
+	+ SIM_CYCLES: run length (default 50000000 = 1s)
+	+ SIM_SW: switch script "val@cycle,val@cycle,..."
+	+ SIM_TRACE: file for a 1ms motor trace (csv)
+###################################################*/
+
+alt_u64 sim_cycles;
+
+alt_u64 sim_end = 50000000;
+
+/*------------------------------------------------/
+ Name:				interrupt controller
+ Description: status.PIE, ienable and the ISR table
+ 	 	 	  filled by alt_ic_isr_register()
+ ------------------------------------------------*/
+
+static alt_u32 sim_status, sim_ienable;
+static int sim_in_isr;
+static struct {
+	alt_isr_func isr;
+	void* context;
+	alt_u64 count;
+} sim_irq[32];
+
+/*------------------------------------------------/
+ Name:				timer model
+ Description: altera_avalon_timer, 32-bit counter
+ 	 	 	  with snapshot. counter holds the value
+ 	 	 	  sampled at cycle 'mark'
+ ------------------------------------------------*/
+
+struct sim_timer {
+	const char* name;
+	alt_u32 base, span;
+	int irq;
+	alt_u32 period, counter, snap;
+	alt_u64 mark;
+	int running, cont, ito, to;
+};
+
+static struct sim_timer sim_timers[] = {
+	{ "timer_0", TIMER_0_BASE, TIMER_0_SPAN, TIMER_0_IRQ, TIMER_0_LOAD_VALUE, TIMER_0_LOAD_VALUE },
+	{ "timer_1", TIMER_1_BASE, TIMER_1_SPAN, TIMER_1_IRQ, TIMER_1_LOAD_VALUE, TIMER_1_LOAD_VALUE },
+	{ "timer_2", TIMER_2_BASE, TIMER_2_SPAN, TIMER_2_IRQ, TIMER_2_LOAD_VALUE, TIMER_2_LOAD_VALUE },
+};
+#define SIM_NTIMERS (sizeof(sim_timers) / sizeof(sim_timers[0]))
+
+static void timer_update(struct sim_timer* t)
+{
+	alt_u64 elapsed;
+
+	if (!t->running) return;
+
+	elapsed = sim_cycles - t->mark;
+	t->mark = sim_cycles;
+	if (elapsed <= t->counter) {
+		t->counter -= elapsed;
+		return;
+	}
+
+	/* counter passed zero: timeout, then reload from period */
+	elapsed -= (alt_u64)t->counter + 1;
+	t->to = 1;
+	if (t->cont) {
+		t->counter = t->period - (alt_u32)(elapsed % ((alt_u64)t->period + 1));
+	} else {
+		t->counter = t->period;
+		t->running = 0;
+	}
+}
+
+static alt_u32 timer_read(struct sim_timer* t, int reg)
+{
+	switch (reg) {
+	case ALTERA_AVALON_TIMER_STATUS_REG:	return t->to | (t->running << 1);
+	case ALTERA_AVALON_TIMER_CONTROL_REG:	return t->ito | (t->cont << 1);
+	case ALTERA_AVALON_TIMER_PERIODL_REG:	return t->period & 0xFFFF;
+	case ALTERA_AVALON_TIMER_PERIODH_REG:	return t->period >> 16;
+	case ALTERA_AVALON_TIMER_SNAPL_REG:		return t->snap & 0xFFFF;
+	case ALTERA_AVALON_TIMER_SNAPH_REG:		return t->snap >> 16;
+	}
+	return 0;
+}
+
+static void timer_write(struct sim_timer* t, int reg, alt_u32 data)
+{
+	switch (reg) {
+	case ALTERA_AVALON_TIMER_STATUS_REG:
+		t->to = 0;
+		break;
+	case ALTERA_AVALON_TIMER_CONTROL_REG:
+		t->ito  = !!(data & ALTERA_AVALON_TIMER_CONTROL_ITO_MSK);
+		t->cont = !!(data & ALTERA_AVALON_TIMER_CONTROL_CONT_MSK);
+		if (data & ALTERA_AVALON_TIMER_CONTROL_STOP_MSK) {
+			t->running = 0;
+		} else if ((data & ALTERA_AVALON_TIMER_CONTROL_START_MSK) && !t->running) {
+			t->running = 1;
+			t->mark = sim_cycles;
+		}
+		break;
+	case ALTERA_AVALON_TIMER_PERIODL_REG:	// writing the period stops the counter
+		t->period = (t->period & 0xFFFF0000) | (data & 0xFFFF);
+		t->counter = t->period;
+		t->running = 0;
+		break;
+	case ALTERA_AVALON_TIMER_PERIODH_REG:
+		t->period = (t->period & 0xFFFF) | ((data & 0xFFFF) << 16);
+		t->counter = t->period;
+		t->running = 0;
+		break;
+	case ALTERA_AVALON_TIMER_SNAPL_REG:
+	case ALTERA_AVALON_TIMER_SNAPH_REG:
+		t->snap = t->counter;
+		break;
+	}
+}
+
+/*------------------------------------------------/
+ Name:				PIO model
+ Description: altera_avalon_pio with direction,
+ 	 	 	  irq mask, edge capture (whole-register
+ 	 	 	  or bit clearing) and the outset/outclear
+ 	 	 	  registers
+ ------------------------------------------------*/
+
+struct sim_pio {
+	const char* name;
+	alt_u32 base, span;
+	int width, irq, bitmod, bitclr;
+	const char* edge_type;
+	const char* irq_type;
+	alt_u32 out, in, dir, mask, edge;
+	alt_u64 reads, writes;
+	void (*on_out)(alt_u32 old, alt_u32 now);	// pins driven (out & dir) changed
+};
+
+static void lcd_pins(alt_u32 old, alt_u32 now);
+static void motor_pins(alt_u32 old, alt_u32 now);
+static struct sim_pio* pio_find(const char* name);
+
+static struct sim_pio sim_pios[] = {
+	{ "LCD",    LCD_BASE, LCD_SPAN,    LCD_DATA_WIDTH,    LCD_IRQ,    LCD_BIT_MODIFYING_OUTPUT_REGISTER, LCD_BIT_CLEARING_EDGE_REGISTER,
+	  LCD_EDGE_TYPE,    LCD_IRQ_TYPE,    0, 0, LCD_HAS_OUT ? 0xFFFFFFFF : 0, 0, 0, 0, 0, lcd_pins },
+	{ "LED",    LED_BASE, LED_SPAN,    LED_DATA_WIDTH,    LED_IRQ,    LED_BIT_MODIFYING_OUTPUT_REGISTER, LED_BIT_CLEARING_EDGE_REGISTER,
+	  LED_EDGE_TYPE,    LED_IRQ_TYPE,    0, 0, 0xFFFFFFFF, 0, 0, 0, 0, NULL },
+	{ "MOTOR",  MOTOR_BASE, MOTOR_SPAN,  MOTOR_DATA_WIDTH,  MOTOR_IRQ,  MOTOR_BIT_MODIFYING_OUTPUT_REGISTER, MOTOR_BIT_CLEARING_EDGE_REGISTER,
+	  MOTOR_EDGE_TYPE,  MOTOR_IRQ_TYPE,  0, 0, 0xFFFFFFFF, 0, 0, 0, 0, motor_pins },
+	{ "SWITCH", SWITCH_BASE, SWITCH_SPAN, SWITCH_DATA_WIDTH, SWITCH_IRQ, SWITCH_BIT_MODIFYING_OUTPUT_REGISTER, SWITCH_BIT_CLEARING_EDGE_REGISTER,
+	  SWITCH_EDGE_TYPE, SWITCH_IRQ_TYPE, 0, 0, 0, 0, 0, 0, 0, NULL },
+	{ "TACH",   TACH_BASE, TACH_SPAN,   TACH_DATA_WIDTH,   TACH_IRQ,   TACH_BIT_MODIFYING_OUTPUT_REGISTER, TACH_BIT_CLEARING_EDGE_REGISTER,
+	  TACH_EDGE_TYPE,   TACH_IRQ_TYPE,   0, 0, 0, 0, 0, 0, 0, NULL },
+};
+#define SIM_NPIOS (sizeof(sim_pios) / sizeof(sim_pios[0]))
+
+static alt_u32 pio_width_mask(struct sim_pio* p)
+{
+	return p->width >= 32 ? 0xFFFFFFFF : ((1u << p->width) - 1);
+}
+
+static void pio_set_out(struct sim_pio* p, alt_u32 value, alt_u32 dir)
+{
+	alt_u32 old = p->out & p->dir;
+
+	p->out = value & pio_width_mask(p);
+	p->dir = dir;
+	if (p->on_out && old != (p->out & p->dir)) p->on_out(old, p->out & p->dir);
+}
+
+static void pio_set_in(struct sim_pio* p, alt_u32 value)
+{
+	alt_u32 rise, fall;
+
+	value &= pio_width_mask(p);
+	rise = value & ~p->in;
+	fall = p->in & ~value;
+	p->in = value;
+
+	if (!strcmp(p->edge_type, "RISING"))       p->edge |= rise;
+	else if (!strcmp(p->edge_type, "FALLING")) p->edge |= fall;
+	else if (!strcmp(p->edge_type, "ANY"))     p->edge |= rise | fall;
+}
+
+static int pio_irq_pending(struct sim_pio* p)
+{
+	if (p->irq < 0) return 0;
+	if (!strcmp(p->irq_type, "EDGE")) return (p->edge & p->mask) != 0;
+	return (p->in & p->mask) != 0;
+}
+
+static alt_u32 pio_read(struct sim_pio* p, int reg)
+{
+	p->reads++;
+	switch (reg) {
+	case 0: return (p->in & ~p->dir) | (p->out & p->dir);
+	case 1: return p->dir;
+	case 2: return p->mask;
+	case 3: return p->edge;
+	}
+	return 0;
+}
+
+static void pio_write(struct sim_pio* p, int reg, alt_u32 data)
+{
+	p->writes++;
+	switch (reg) {
+	case 0: pio_set_out(p, data, p->dir); break;
+	case 1: pio_set_out(p, p->out, data); break;
+	case 2: p->mask = data; break;
+	case 3: p->edge = p->bitclr ? p->edge & ~data : 0; break;
+	case 4: if (p->bitmod) pio_set_out(p, p->out | data, p->dir); break;
+	case 5: if (p->bitmod) pio_set_out(p, p->out & ~data, p->dir); break;
+	}
+}
+
+/*------------------------------------------------/
+ Name:				HD44780 model
+ Description: decodes RS RW E D7..D0 on the LCD PIO
+ 	 	 	  (falling edge of E latches the byte)
+ 	 	 	  and flags writes issued while the
+ 	 	 	  controller is still busy. A read
+ 	 	 	  (RW=1) puts BF and AC on D7..D0 while E
+ 	 	 	  is high; the PIO still driving them
+ 	 	 	  then is a bus conflict
+ ------------------------------------------------*/
+
+#define LCD_EXEC_CYCLES		1850		// 37us
+#define LCD_CLEAR_CYCLES	76000		// 1.52ms
+#define LCD_PW_EH_CYCLES	23			// 450ns enable pulse width
+
+static struct {
+	alt_u8 ddram[0x80];
+	alt_u8 cgram[0x40];
+	alt_u32 ac;
+	int cg, dec;
+	alt_u64 e_rise, busy_until;
+	alt_u64 cmds, datas, reads, busy_violations, pulse_violations, conflicts;
+} lcd;
+
+/* 16 cells as text: a CGRAM glyph (codes 0..15) as the number of its lit
+ * pixel columns, the ROM block 0xFF as '#' */
+static const char* lcd_row_text(alt_u32 addr)
+{
+	static char text[17];
+	alt_u8 c, cols;
+	int i, r;
+
+	for (i = 0; i < 16; i++) {
+		c = lcd.ddram[addr + i];
+		if (c < 16) {
+			for (cols = 0, r = 0; r < 8; r++) cols |= lcd.cgram[(c & 7) * 8 + r];
+			text[i] = '0' + __builtin_popcount(cols & 0x1F);
+		} else {
+			text[i] = c == 0xFF ? '#' : c;
+		}
+	}
+	text[16] = 0;
+	return text;
+}
+
+static void lcd_exec(int rs, alt_u8 v, alt_u64 at)
+{
+	alt_u32 exec = LCD_EXEC_CYCLES;
+
+	if (rs) {
+		lcd.datas++;
+		if (lcd.cg) lcd.cgram[lcd.ac & 0x3F] = v;
+		else        lcd.ddram[lcd.ac & 0x7F] = v;
+		lcd.ac = lcd.dec ? lcd.ac - 1 : lcd.ac + 1;
+	} else {
+		lcd.cmds++;
+		if (v & 0x80) {
+			lcd.cg = 0;
+			lcd.ac = v & 0x7F;
+		} else if (v & 0x40) {
+			lcd.cg = 1;
+			lcd.ac = v & 0x3F;
+		} else if (v == 0x01) {
+			memset(lcd.ddram, ' ', sizeof(lcd.ddram));
+			lcd.ac = 0;
+			lcd.cg = 0;
+			lcd.dec = 0;
+			exec = LCD_CLEAR_CYCLES;
+		} else if ((v & 0xFE) == 0x02) {
+			lcd.ac = 0;
+			lcd.cg = 0;
+			exec = LCD_CLEAR_CYCLES;
+		} else if ((v & 0xFC) == 0x04) {	// entry mode set
+			lcd.dec = !(v & 0x02);
+		}
+	}
+	lcd.busy_until = at + exec;
+}
+
+static void lcd_pins(alt_u32 old, alt_u32 now)
+{
+	int e_old = (old >> 8) & 1, e_now = (now >> 8) & 1;
+
+	struct sim_pio* p = pio_find("LCD");
+
+	if (!e_old && e_now) {
+		lcd.e_rise = sim_cycles;
+		if ((now >> 9) & 1) {				// RW = 1: the LCD drives D7..D0
+			if (p->dir & 0xFF) lcd.conflicts++;
+			pio_set_in(p, (sim_cycles < lcd.busy_until ? 0x80 : 0) | (lcd.ac & 0x7F));
+		}
+		return;
+	}
+	if (!(e_old && !e_now)) return;
+
+	if (sim_cycles - lcd.e_rise < LCD_PW_EH_CYCLES) lcd.pulse_violations++;
+	if ((now >> 9) & 1) {					// RW = 1: read cycle
+		lcd.reads++;
+		pio_set_in(p, 0);
+		return;
+	}
+	if (sim_cycles < lcd.busy_until) lcd.busy_violations++;
+	lcd_exec((now >> 10) & 1, now & 0xFF, sim_cycles);
+}
+
+/*------------------------------------------------/
+ Name:				lcd_refresh_0 model
+ Description: TEXT, CGRAM, CONTROL and STATUS as
+ 	 	 	  in lcd_refresh.v. The sequencer is
+ 	 	 	  run lazily one byte at a time with the
+ 	 	 	  core's timing and each byte goes to the
+ 	 	 	  HD44780 model at its E falling edge
+ ------------------------------------------------*/
+
+#define LCDREF_AS_CYCLES	3			// lcd_refresh.v at 50MHz
+#define LCDREF_EH_CYCLES	25
+#define LCDREF_EXEC_CYCLES	2500
+#define LCDREF_CLEAR_CYCLES	82000
+#define LCDREF_POWER_CYCLES	2000000
+
+static const alt_u8 lcdref_init[] = { 0x38, 0x0C, 0x06, 0x01 };
+
+static struct {
+	alt_u8 text[32], cgram[64];
+	alt_u32 text_dirty, glyph_dirty, run;
+	int init_step, glyph_busy, glyph_slot, glyph_row, ac_valid;
+	alt_u32 ac;
+	alt_u64 idle_at;						// cycle the sequencer is back in S_IDLE
+	alt_u64 writes;
+} lcdref = { .text_dirty = 0xFFFFFFFF, .glyph_dirty = 0xFF, .idle_at = LCDREF_POWER_CYCLES };
+
+static void lcdref_send(int rs, alt_u8 v)
+{
+	alt_u64 fall = lcdref.idle_at + LCDREF_AS_CYCLES + LCDREF_EH_CYCLES;
+
+	if (fall < lcd.busy_until) lcd.busy_violations++;
+	if (LCDREF_EH_CYCLES < LCD_PW_EH_CYCLES) lcd.pulse_violations++;
+	lcd_exec(rs, v, fall);
+	lcdref.idle_at = fall + (!rs && v <= 0x03 ? LCDREF_CLEAR_CYCLES : LCDREF_EXEC_CYCLES);
+}
+
+static void lcdref_update(void)
+{
+	int cell, slot;
+	alt_u32 addr;
+
+	while (lcdref.idle_at <= sim_cycles) {
+		if (!lcdref.run) {
+			lcdref.init_step = 0;
+			lcdref.text_dirty = 0xFFFFFFFF;
+			lcdref.glyph_dirty = 0xFF;
+			lcdref.glyph_busy = 0;
+			lcdref.ac_valid = 0;
+			break;
+		}
+		if (lcdref.init_step < 4) {
+			lcdref_send(0, lcdref_init[lcdref.init_step++]);
+		} else if (lcdref.glyph_busy) {
+			lcdref_send(1, lcdref.cgram[lcdref.glyph_slot * 8 + lcdref.glyph_row]);
+			if (++lcdref.glyph_row == 8) lcdref.glyph_busy = 0;
+		} else if (lcdref.glyph_dirty) {
+			slot = __builtin_ctz(lcdref.glyph_dirty);
+			lcdref.glyph_dirty &= ~(1u << slot);
+			lcdref.glyph_slot = slot;
+			lcdref.glyph_row = 0;
+			lcdref.glyph_busy = 1;
+			lcdref.ac_valid = 0;
+			lcdref_send(0, 0x40 | slot << 3);
+		} else if (lcdref.text_dirty) {
+			cell = __builtin_ctz(lcdref.text_dirty);
+			addr = (cell & 0x10) << 2 | (cell & 0x0F);
+			if (lcdref.ac_valid && lcdref.ac == addr) {
+				lcdref.text_dirty &= ~(1u << cell);
+				lcdref.ac = (addr + 1) & 0x7F;
+				lcdref_send(1, lcdref.text[cell]);
+			} else {
+				lcdref.ac = addr;
+				lcdref.ac_valid = 1;
+				lcdref_send(0, 0x80 | addr);
+			}
+		} else {
+			break;
+		}
+	}
+	if (lcdref.idle_at < sim_cycles) lcdref.idle_at = sim_cycles;	// idle until the next write
+}
+
+static alt_u32 lcdref_read(int reg)
+{
+	alt_u32 value = 0;
+	int i;
+
+	lcdref_update();
+	if (reg < 8) {
+		for (i = 3; i >= 0; i--) value = value << 8 | lcdref.text[reg * 4 + i];
+	} else if (reg < 24) {
+		for (i = 3; i >= 0; i--) value = value << 8 | lcdref.cgram[(reg - 8) * 4 + i];
+	} else if (reg == 24) {
+		value = lcdref.run;
+	} else if (reg == 25) {
+		if (lcdref.run && (lcdref.idle_at > sim_cycles || lcdref.init_step < 4 || lcdref.glyph_busy
+				|| lcdref.glyph_dirty || lcdref.text_dirty))
+			value |= LCD_REFRESH_STATUS_BUSY_MSK;
+		if (lcdref.init_step == 4) value |= LCD_REFRESH_STATUS_READY_MSK;
+	}
+	return value;
+}
+
+static void lcdref_write(int reg, alt_u32 data)
+{
+	alt_u8 v;
+	int i, n;
+
+	lcdref_update();
+	lcdref.writes++;
+	for (i = 0; i < 4 && reg < 24; i++) {
+		if (reg < 8) {
+			n = reg * 4 + i;
+			v = data >> (8 * i);
+			if (lcdref.text[n] != v) lcdref.text_dirty |= 1u << n;
+			lcdref.text[n] = v;
+		} else {
+			n = (reg - 8) * 4 + i;
+			v = (data >> (8 * i)) & LCD_REFRESH_CGRAM_ROW_MSK;
+			if (lcdref.cgram[n] != v) lcdref.glyph_dirty |= 1u << (n / 8);
+			lcdref.cgram[n] = v;
+		}
+	}
+	if (reg == 24) lcdref.run = data & LCD_REFRESH_CONTROL_RUN_MSK;
+	lcdref_update();
+}
+
+/*------------------------------------------------/
+ Name:				hex_display_0 model
+ Description: the four registers; the report
+ 	 	 	  renders HEX5..HEX0 as characters
+ ------------------------------------------------*/
+
+static struct {
+	alt_u32 reg[4];
+	alt_u64 writes;
+} hexdisp = { { 0, 0, 0, HEX_DISPLAY_CONTROL_BLANK_MSK }, 0 };
+
+/* segments a..g back to a character, '?' for a pattern not in the table */
+static char hex_seg_char(alt_u32 seg)
+{
+	static const struct { alt_u8 seg; char c; } table[] = {
+		{ 0x3F, '0' }, { 0x06, '1' }, { 0x5B, '2' }, { 0x4F, '3' }, { 0x66, '4' },
+		{ 0x6D, '5' }, { 0x7D, '6' }, { 0x07, '7' }, { 0x7F, '8' }, { 0x6F, '9' },
+		{ 0x77, 'A' }, { 0x7C, 'b' }, { 0x39, 'C' }, { 0x5E, 'd' }, { 0x79, 'E' },
+		{ 0x71, 'F' }, { 0x38, 'L' }, { 0x40, '-' }, { 0x00, ' ' }
+	};
+	unsigned int i;
+
+	for (i = 0; i < sizeof(table) / sizeof(table[0]); i++)
+		if (table[i].seg == seg) return table[i].c;
+	return '?';
+}
+
+static const char* hexdisp_text(void)
+{
+	static const char digit[] = "0123456789AbCdEF";
+	static char text[7];
+	alt_u32 control = hexdisp.reg[3], n, seg;
+
+	for (n = 0; n < 6; n++) {
+		seg = (n < 4 ? hexdisp.reg[1] : hexdisp.reg[2]) >> HEX_DISPLAY_SEG_OFST(n) & HEX_DISPLAY_SEG_MSK;
+		if (control >> (HEX_DISPLAY_CONTROL_BLANK_OFST + n) & 1) text[5 - n] = ' ';
+		else if (control >> n & 1)                             text[5 - n] = hex_seg_char(seg);
+		else text[5 - n] = digit[hexdisp.reg[0] >> HEX_DISPLAY_DIGIT_OFST(n) & 0xF];
+	}
+	text[6] = 0;
+	return text;
+}
+
+/*------------------------------------------------/
+ Name:				cycle_counter_0 model
+ Description: the model's own cycle count, reads
+ 	 	 	  counted
+ ------------------------------------------------*/
+
+static alt_u64 cyccnt_reads;
+
+/*------------------------------------------------/
+ Name:				PWM monitor
+ Description: IN1..IN4 from the MOTOR PIO or the
+ 	 	 	  motor_pwm_0 output. Measures period
+ 	 	 	  and duty cycle of channel A being
+ 	 	 	  driven (IN1 != IN2)
+ ------------------------------------------------*/
+
+static struct {
+	alt_u64 rise, fall, writes, periods, sum_period, sum_high;
+	alt_u32 min_duty, max_duty;			// in 1/10000
+	int level;
+	alt_u32 pins;
+} motor = { 0, 0, 0, 0, 0, 0, 10000, 0, 0, 0 };
+
+/*------------------------------------------------/
+ Name:				reversal monitor
+ Description: per L298 channel, the time between
+ 	 	 	  the last cycle one direction was
+ 	 	 	  driven (IN1 xor IN2) and the first
+ 	 	 	  cycle the other one is. 0 is a direct
+ 	 	 	  FORWARD <-> REVERSE change
+ ------------------------------------------------*/
+
+static struct {
+	int dir;							// 1 IN1 only, 2 IN2 only, 0 never driven
+	int driven;							// dir is on the pins now
+	alt_u64 off;						// cycle dir stopped being driven
+	alt_u64 reversals, min_gap;
+} reversal[2] = { { 0, 0, 0, 0, ~0ull }, { 0, 0, 0, 0, ~0ull } };
+
+static void reversal_edge(alt_u32 pins, alt_u64 at)
+{
+	alt_u32 ch, in;
+	int dir;
+
+	for (ch = 0; ch < 2; ch++) {
+		in = (pins >> (2 * ch)) & 3;
+		dir = in == 1 ? 1 : in == 2 ? 2 : 0;
+		if (dir && reversal[ch].dir && dir != reversal[ch].dir) {
+			alt_u64 gap = reversal[ch].driven ? 0 : at - reversal[ch].off;
+			reversal[ch].reversals++;
+			if (gap < reversal[ch].min_gap) reversal[ch].min_gap = gap;
+		}
+		if (dir) {
+			reversal[ch].dir = dir;
+			reversal[ch].driven = 1;
+		} else if (reversal[ch].driven) {
+			reversal[ch].driven = 0;
+			reversal[ch].off = at;
+		}
+	}
+}
+
+/* reversals of a channel and the shortest undriven time before one (cycles) */
+void sim_reversal_sample(alt_u32 ch, alt_u64* reversals, alt_u64* min_gap)
+{
+	*reversals = reversal[ch].reversals;
+	*min_gap = reversal[ch].min_gap;
+	reversal[ch].reversals = 0;
+	reversal[ch].min_gap = ~0ull;
+}
+
+static void plant_advance(alt_u64 to);
+
+static void motor_edge(alt_u32 pins, alt_u64 at)
+{
+	int level = ((pins >> 1) ^ pins) & 1;
+
+	if (pins == motor.pins) return;
+	plant_advance(at);
+	reversal_edge(pins, at);
+	motor.pins = pins;
+	if (level == motor.level) return;
+	motor.level = level;
+
+	if (!level) {
+		motor.fall = at;
+		return;
+	}
+	if (motor.rise && motor.fall > motor.rise) {
+		alt_u64 period = at - motor.rise;
+		alt_u64 high = motor.fall - motor.rise;
+		alt_u32 duty = (alt_u32)(high * 10000 / period);
+
+		motor.periods++;
+		motor.sum_period += period;
+		motor.sum_high += high;
+		if (duty < motor.min_duty) motor.min_duty = duty;
+		if (duty > motor.max_duty) motor.max_duty = duty;
+	}
+	motor.rise = at;
+}
+
+static void motor_pins(alt_u32 old, alt_u32 now)
+{
+	motor.writes++;
+	motor_edge(now & 0xF, sim_cycles);
+}
+
+/* HIGH and period cycles of channel A measured since the previous call */
+void sim_pwm_sample(alt_u64* high, alt_u64* period)
+{
+	static alt_u64 last_high, last_period;
+
+	*high = motor.sum_high - last_high;
+	*period = motor.sum_period - last_period;
+	last_high = motor.sum_high;
+	last_period = motor.sum_period;
+}
+
+/*------------------------------------------------/
+ Name:				motor plant
+ Description: L298 channel A + brushed DC motor,
+ 	 	 	  integrated in 1us steps:
+ 	 	 	    L di/dt = v - R i - Ke w
+ 	 	 	    J dw/dt = Kt i - B w - Tload
+ 	 	 	  v = +Vs for IN1 only, -Vs for IN2 only.
+ 	 	 	  Both high (brake) shorts the winding,
+ 	 	 	  both low (coast) lets the current decay
+ 	 	 	  to zero but not reverse. The shaft
+ 	 	 	  angle produces PLANT_PPR tachometer
+ 	 	 	  pulses per revolution, either way
+ ------------------------------------------------*/
+
+#define PLANT_VS		12.0			// V
+#define PLANT_R			2.0				// ohm
+#define PLANT_L			2e-3			// H   (electrical tau 1ms)
+#define PLANT_K			0.033			// V s/rad = N m/A
+#define PLANT_J			2e-5			// kg m^2 (mechanical tau ~37ms)
+#define PLANT_B			5e-6			// N m s/rad
+#define PLANT_LOAD		2e-3			// N m
+#define PLANT_PPR		12
+#define PLANT_STEP		50				// cycles per integration step
+#define PLANT_PI		3.14159265358979
+
+static struct {
+	alt_u64 t;							// cycle the state belongs to
+	double i, w, angle;					// A, rad/s (signed), rad within one pulse
+	double level_sum;					// pwm level integral for the trace
+	alt_u64 sample_at;
+	double* rpm;						// one sample per ms
+	size_t samples, cap;
+	FILE* trace;
+} plant;
+
+static void plant_sample(void)
+{
+	double rpm = plant.w * 60 / (2 * PLANT_PI);
+
+	if (plant.samples == plant.cap) {
+		plant.cap = plant.cap ? plant.cap * 2 : 4096;
+		plant.rpm = realloc(plant.rpm, plant.cap * sizeof(double));
+	}
+	plant.rpm[plant.samples++] = rpm;
+	if (plant.trace)
+		fprintf(plant.trace, "%zu,%.1f,%.4f,%.4f\n", plant.samples, rpm, plant.i,
+				plant.level_sum * PLANT_STEP / 50000);
+	plant.level_sum = 0;
+}
+
+static void plant_advance(alt_u64 to)
+{
+	struct sim_pio* tach = pio_find("TACH");
+	double dt = PLANT_STEP / 50e6;
+
+	while (plant.t + PLANT_STEP <= to) {
+		alt_u32 in = motor.pins & 3;
+		double v = in == 1 ? PLANT_VS : in == 2 ? -PLANT_VS : 0;
+		double di = (v - PLANT_R * plant.i - PLANT_K * plant.w) / PLANT_L;
+		double load = plant.w > 0 ? PLANT_LOAD : plant.w < 0 ? -PLANT_LOAD : 0;
+		double torque = PLANT_K * plant.i - PLANT_B * plant.w - load;
+		double i = plant.i, w = plant.w;
+
+		plant.i += di * dt;
+		if (in == 0 && i * plant.i <= 0) plant.i = 0;	// coast: no current through zero
+		plant.w += torque / PLANT_J * dt;
+		if (load != 0 && w * plant.w < 0) plant.w = 0;	// friction stops, it does not reverse
+		if (load == 0 && fabs(PLANT_K * plant.i) < PLANT_LOAD) plant.w = 0;
+		plant.t += PLANT_STEP;
+		plant.level_sum += (in == 1) - (in == 2);
+
+		plant.angle += fabs(plant.w) * dt;
+		if (plant.angle >= 2 * PLANT_PI / PLANT_PPR) {
+			plant.angle -= 2 * PLANT_PI / PLANT_PPR;
+			pio_set_in(tach, 1);
+			pio_set_in(tach, 0);
+		}
+		if (plant.t >= plant.sample_at) {
+			plant_sample();
+			plant.sample_at += 50000;
+		}
+	}
+}
+
+/*------------------------------------------------/
+ Name:				motor_pwm model
+ Description: ip/motor_pwm/motor_pwm.v. PERIOD,
+ 	 	 	  both COMPAREs (plus the dither carry)
+ 	 	 	  and OUTPUT are latched at each period
+ 	 	 	  start unless HOLD is set, edges are
+ 	 	 	  produced lazily up to the current cycle
+ ------------------------------------------------*/
+
+static struct {
+	alt_u32 period, compare[2], output, enable, hold, dither[2];
+	alt_u32 period_act, compare_act[2], output_act, acc[2];
+	alt_u64 start;							// cycle the running period began
+	alt_u32 done;							// cycles of the period already output
+	alt_u64 writes;
+	int running;
+} hwpwm;
+
+static alt_u32 hwpwm_pins(alt_u32 at)
+{
+	alt_u32 pins = 0, ch, out;
+
+	for (ch = 0; ch < 2; ch++) {
+		out = hwpwm.output_act >> (ch * MOTOR_PWM_OUTPUT_CHANNEL_OFST);
+		pins |= (at < hwpwm.compare_act[ch] ? out >> MOTOR_PWM_OUTPUT_A_HIGH_OFST
+											: out >> MOTOR_PWM_OUTPUT_A_LOW_OFST) & 0xF;
+	}
+	return pins;
+}
+
+static void hwpwm_latch(alt_u64 at)
+{
+	alt_u32 ch;
+
+	hwpwm.start = at;
+	hwpwm.done = 0;
+	hwpwm.period_act = hwpwm.period;
+	for (ch = 0; ch < 2; ch++) {
+		hwpwm.acc[ch] += hwpwm.dither[ch];
+		hwpwm.compare_act[ch] = hwpwm.compare[ch] + (hwpwm.acc[ch] >> 16);
+		hwpwm.acc[ch] &= 0xFFFF;
+	}
+	hwpwm.output_act = hwpwm.output;
+	motor_edge(hwpwm_pins(0), at);
+}
+
+static void hwpwm_update(void)
+{
+	while (hwpwm.running) {
+		alt_u64 end = hwpwm.start + hwpwm.period_act;
+		alt_u32 ch, edge;
+
+		for (;;) {									// compare edges in time order
+			edge = hwpwm.period_act;
+			for (ch = 0; ch < 2; ch++)
+				if (hwpwm.compare_act[ch] > hwpwm.done && hwpwm.compare_act[ch] < edge)
+					edge = hwpwm.compare_act[ch];
+			if (edge == hwpwm.period_act || hwpwm.start + edge > sim_cycles) break;
+			hwpwm.done = edge;
+			motor_edge(hwpwm_pins(edge), hwpwm.start + edge);
+		}
+		if (end > sim_cycles) break;
+		if (hwpwm.hold) {						// repeat the running period
+			hwpwm.start = end;
+			hwpwm.done = 0;
+			motor_edge(hwpwm_pins(0), end);
+		} else {
+			hwpwm_latch(end);
+		}
+	}
+}
+
+static alt_u32 hwpwm_read(int reg)
+{
+	switch (reg) {
+	case 0: return hwpwm.period;
+	case 1: return hwpwm.compare[0];
+	case 2: return hwpwm.output;
+	case 3: return hwpwm.enable | hwpwm.hold;
+	case 4: return hwpwm.compare[1];
+	case 5: return hwpwm.dither[0];
+	}
+	return hwpwm.dither[1];
+}
+
+static void hwpwm_write(int reg, alt_u32 data)
+{
+	hwpwm_update();
+	hwpwm.writes++;
+	switch (reg) {
+	case 0: hwpwm.period = data; break;
+	case 1: hwpwm.compare[0] = data; break;
+	case 2: hwpwm.output = data & MOTOR_PWM_OUTPUT_MSK; break;
+	case 3:
+		hwpwm.enable = data & MOTOR_PWM_ENABLE_MSK;
+		hwpwm.hold = data & MOTOR_PWM_ENABLE_HOLD_MSK;
+		break;
+	case 4: hwpwm.compare[1] = data; break;
+	case 5: hwpwm.dither[0] = data & MOTOR_PWM_DITHER_MSK; break;
+	case 6: hwpwm.dither[1] = data & MOTOR_PWM_DITHER_MSK; break;
+	}
+	if (!hwpwm.enable || !hwpwm.period) {
+		hwpwm.running = 0;
+		motor_edge(0, sim_cycles);
+	} else if (!hwpwm.running) {
+		hwpwm.running = 1;
+		hwpwm_latch(sim_cycles);
+	}
+}
+
+/*------------------------------------------------/
+ Name:				switch script
+ Description: SIM_SW="0x2@0,0x4@50000000" applies
+ 	 	 	  each value once the clock reaches its
+ 	 	 	  cycle
+ ------------------------------------------------*/
+
+#define SIM_SW_EVENTS 32
+
+static struct { alt_u64 at; alt_u32 value; } sim_sw[SIM_SW_EVENTS];
+static int sim_sw_count, sim_sw_next;
+
+static void switch_script_parse(const char* s)
+{
+	while (s && *s && sim_sw_count < SIM_SW_EVENTS) {
+		char* end;
+
+		sim_sw[sim_sw_count].value = strtoul(s, &end, 0);
+		sim_sw[sim_sw_count].at = (*end == '@') ? strtoull(end + 1, &end, 0) : 0;
+		sim_sw_count++;
+		s = (*end == ',') ? end + 1 : NULL;
+	}
+}
+
+static struct sim_pio* pio_find(const char* name)
+{
+	unsigned int i;
+
+	for (i = 0; i < SIM_NPIOS; i++)
+		if (!strcmp(sim_pios[i].name, name)) return &sim_pios[i];
+	return NULL;
+}
+
+/*------------------------------------------------/
+ Name:				plant_report
+ Description: step response after the last switch
+ 	 	 	  change: final speed (mean of the last
+ 	 	 	  100ms), overshoot and 2% settling time
+ ------------------------------------------------*/
+
+static void plant_report(void)
+{
+	size_t from = 0, n, k, settle;
+	double final = 0, peak, over;
+
+	if (plant.trace) fclose(plant.trace);
+	if (sim_sw_next) from = sim_sw[sim_sw_next - 1].at / 50000;
+	if (plant.samples < from + 200) {
+		fprintf(stderr, "sim: motor %.0f rpm (run too short for a step response)\n",
+				plant.w * 60 / (2 * PLANT_PI));
+		return;
+	}
+
+	for (n = 0, k = plant.samples - 100; k < plant.samples; k++, n++) final += plant.rpm[k];
+	final /= n;
+	settle = from;
+	peak = final;
+	for (k = from; k < plant.samples; k++) {
+		if (plant.rpm[from] <= final ? plant.rpm[k] > peak : plant.rpm[k] < peak) peak = plant.rpm[k];
+		if (plant.rpm[k] > final * 1.02 || plant.rpm[k] < final * 0.98) settle = k + 1;
+	}
+	over = final > 0 ? (peak - final) * 100 / final : 0.0;
+	fprintf(stderr, "sim: motor %.0f rpm, peak %.0f rpm (overshoot %.1f%%), settled to 2%% in %zu ms\n",
+			final, peak, over < 0 ? -over : over, settle - from);
+}
+
+/*------------------------------------------------/
+ Name:				report
+ Description: printed on stderr when the run ends,
+ 	 	 	  stdout carries the JTAG UART stream
+ ------------------------------------------------*/
+
+static void sim_report(void)
+{
+	unsigned int i;
+	alt_u32 nticks;
+
+	sim_end = ~(alt_u64)0;					// the register reads below must not end the run again
+	nticks = alt_nticks();
+
+	fprintf(stderr, "sim: %llu cycles (%.6f s)\n",
+			(unsigned long long)sim_cycles, sim_cycles / 50e6);
+	for (i = 0; i < SIM_NPIOS; i++)
+		fprintf(stderr, "sim: %-6s reads %llu writes %llu out 0x%03lx\n", sim_pios[i].name,
+				(unsigned long long)sim_pios[i].reads, (unsigned long long)sim_pios[i].writes,
+				(unsigned long)sim_pios[i].out);
+	for (i = 0; i < 32; i++)
+		if (sim_irq[i].count)
+			fprintf(stderr, "sim: irq %u taken %llu times\n", i, (unsigned long long)sim_irq[i].count);
+	fprintf(stderr, "sim: sys clock %lu ticks, %llu from the cycle count\n",
+			(unsigned long)nticks, (unsigned long long)(sim_cycles / (TIMER_0_LOAD_VALUE + 1)));
+
+	fprintf(stderr, "sim: lcd cmds %llu data %llu reads %llu busy-violations %llu pulse-violations %llu bus-conflicts %llu\n",
+			(unsigned long long)lcd.cmds, (unsigned long long)lcd.datas, (unsigned long long)lcd.reads,
+			(unsigned long long)lcd.busy_violations, (unsigned long long)lcd.pulse_violations,
+			(unsigned long long)lcd.conflicts);
+	fprintf(stderr, "sim: lcd_refresh writes %llu run %lu\n",
+			(unsigned long long)lcdref.writes, (unsigned long)lcdref.run);
+	fprintf(stderr, "sim: lcd |%s|\n", lcd_row_text(0x00));
+	fprintf(stderr, "sim: lcd |%s|\n", lcd_row_text(0x40));
+
+	fprintf(stderr, "sim: cycle_counter reads %llu\n", (unsigned long long)cyccnt_reads);
+	fprintf(stderr, "sim: hex writes %llu |%s|\n", (unsigned long long)hexdisp.writes, hexdisp_text());
+	fprintf(stderr, "sim: motor_pwm writes %llu period %lu compare %lu/%lu output 0x%04lx enable %lu\n",
+			(unsigned long long)hwpwm.writes, (unsigned long)hwpwm.period,
+			(unsigned long)hwpwm.compare[0], (unsigned long)hwpwm.compare[1],
+			(unsigned long)hwpwm.output, (unsigned long)hwpwm.enable);
+	plant_report();
+	for (i = 0; i < 2; i++)
+		if (reversal[i].reversals)
+			fprintf(stderr, "sim: channel %u reversals %llu, shortest dead-time %llu us\n", i,
+					(unsigned long long)reversal[i].reversals,
+					(unsigned long long)(reversal[i].min_gap / 50));
+	if (motor.periods)
+		fprintf(stderr, "sim: pwm periods %llu avg %llu cycles duty %.2f%% (min %.2f%% max %.2f%%)\n",
+				(unsigned long long)motor.periods,
+				(unsigned long long)(motor.sum_period / motor.periods),
+				motor.sum_high * 100.0 / motor.sum_period,
+				motor.min_duty / 100.0, motor.max_duty / 100.0);
+	else
+		fprintf(stderr, "sim: pwm no complete periods, level %d\n", motor.level);
+}
+
+/*------------------------------------------------/
+ Name:				sim_step
+ Description: advance the clock, apply switch
+ 	 	 	  changes, update timers and take any
+ 	 	 	  pending interrupt
+ ------------------------------------------------*/
+
+static alt_u32 sim_ipending(void)
+{
+	alt_u32 pending = 0;
+	unsigned int i;
+
+	for (i = 0; i < SIM_NTIMERS; i++) {
+		timer_update(&sim_timers[i]);
+		if (sim_timers[i].to && sim_timers[i].ito) pending |= 1u << sim_timers[i].irq;
+	}
+	for (i = 0; i < SIM_NPIOS; i++)
+		if (pio_irq_pending(&sim_pios[i])) pending |= 1u << sim_pios[i].irq;
+	return pending;
+}
+
+static void sim_dispatch(void)
+{
+	alt_u32 pending;
+
+	while (!sim_in_isr && (sim_status & NIOS2_STATUS_PIE_MSK)
+			&& (pending = sim_ipending() & sim_ienable)) {
+		int irq = __builtin_ctz(pending);		// lowest number = highest priority
+
+		sim_in_isr = 1;
+		sim_status &= ~NIOS2_STATUS_PIE_MSK;
+		sim_cycles += SIM_IRQ_CYCLES;
+		sim_irq[irq].count++;
+		sim_irq[irq].isr(sim_irq[irq].context);
+		sim_status |= NIOS2_STATUS_PIE_MSK;
+		sim_in_isr = 0;
+	}
+}
+
+static void sim_step(alt_u32 cycles)
+{
+	sim_cycles += cycles;
+
+	while (sim_sw_next < sim_sw_count && sim_sw[sim_sw_next].at <= sim_cycles)
+		pio_set_in(pio_find("SWITCH"), sim_sw[sim_sw_next++].value);
+	hwpwm_update();
+	lcdref_update();
+	plant_advance(sim_cycles);
+
+	if (sim_cycles >= sim_end) {
+		sim_report();
+		exit(0);
+	}
+	sim_dispatch();
+}
+
+/* idle time: stepped from one timer timeout to the next, so timer
+ * interrupts are taken on the cycle they are due */
+static alt_u64 sim_timer_due(void)
+{
+	alt_u64 due = ~0ull, elapsed;
+	unsigned int i;
+
+	for (i = 0; i < SIM_NTIMERS; i++) {
+		struct sim_timer* t = &sim_timers[i];
+		if (!t->running || !t->ito) continue;
+		elapsed = sim_cycles - t->mark;
+		if (elapsed > t->counter) return 1;
+		if (t->counter - elapsed + 1 < due) due = t->counter - elapsed + 1;
+	}
+	return due;
+}
+
+void sim_advance(alt_u32 cycles)
+{
+	alt_u64 step;
+
+	while (cycles) {
+		step = sim_timer_due();
+		if (step > cycles) step = cycles;
+		sim_step((alt_u32)step);
+		cycles -= (alt_u32)step;
+	}
+}
+
+/*------------------------------------------------/
+ Name:				bus access
+ Description: IORD/IOWR land here through the
+ 	 	 	  builtin macros in sim_host.h
+ ------------------------------------------------*/
+
+static alt_u32 sim_access(alt_u32 addr, int write, alt_u32 data)
+{
+	alt_u32 value = 0;
+	unsigned int i;
+
+	for (i = 0; i < SIM_NTIMERS; i++) {
+		struct sim_timer* t = &sim_timers[i];
+		if (addr >= t->base && addr < t->base + t->span) {
+			timer_update(t);
+			if (write) timer_write(t, (addr - t->base) / 4, data);
+			else       value = timer_read(t, (addr - t->base) / 4);
+			return value;
+		}
+	}
+	for (i = 0; i < SIM_NPIOS; i++) {
+		struct sim_pio* p = &sim_pios[i];
+		if (addr >= p->base && addr < p->base + p->span) {
+			if (write) pio_write(p, (addr - p->base) / 4, data);
+			else       value = pio_read(p, (addr - p->base) / 4);
+			return value;
+		}
+	}
+	if (addr >= MOTOR_PWM_0_BASE && addr < MOTOR_PWM_0_BASE + MOTOR_PWM_0_SPAN) {
+		if (write) hwpwm_write((addr - MOTOR_PWM_0_BASE) / 4, data);
+		else       value = hwpwm_read((addr - MOTOR_PWM_0_BASE) / 4);
+		return value;
+	}
+	if (addr >= HEX_DISPLAY_0_BASE && addr < HEX_DISPLAY_0_BASE + HEX_DISPLAY_0_SPAN) {
+		if (write) {
+			hexdisp.writes++;
+			hexdisp.reg[(addr - HEX_DISPLAY_0_BASE) / 4] = data;
+		}
+		return hexdisp.reg[(addr - HEX_DISPLAY_0_BASE) / 4];
+	}
+	if (addr >= CYCLE_COUNTER_0_BASE && addr < CYCLE_COUNTER_0_BASE + CYCLE_COUNTER_0_SPAN) {
+		if (write) return 0;
+		cyccnt_reads++;
+		return addr == CYCLE_COUNTER_0_BASE ? (alt_u32)sim_cycles : (alt_u32)(sim_cycles >> 32);
+	}
+	if (addr >= LCD_REFRESH_0_BASE && addr < LCD_REFRESH_0_BASE + LCD_REFRESH_0_SPAN) {
+		if (write) lcdref_write((addr - LCD_REFRESH_0_BASE) / 4, data);
+		else       value = lcdref_read((addr - LCD_REFRESH_0_BASE) / 4);
+		return value;
+	}
+	if (addr >= JTAG_UART_0_BASE && addr < JTAG_UART_0_BASE + JTAG_UART_0_SPAN) {
+		if (addr == JTAG_UART_0_BASE + 4) return (alt_u32)JTAG_UART_0_WRITE_DEPTH << 16;	// WSPACE
+		if (write && addr == JTAG_UART_0_BASE) putchar(data & 0xFF);
+		return 0;
+	}
+	fprintf(stderr, "sim: %s of unmapped address 0x%08lx\n", write ? "write" : "read", (unsigned long)addr);
+	return 0;
+}
+
+alt_u32 sim_iord(alt_u32 addr)
+{
+	alt_u32 value;
+
+	sim_step(SIM_IORD_CYCLES);
+	value = sim_access(addr, 0, 0);
+	return value;
+}
+
+void sim_iowr(alt_u32 addr, alt_u32 data)
+{
+	sim_step(SIM_IOWR_CYCLES);
+	sim_access(addr, 1, data);
+	sim_dispatch();
+}
+
+/*------------------------------------------------/
+ Name:				control registers
+ Description: rdctl/wrctl for status, ienable and
+ 	 	 	  ipending
+ ------------------------------------------------*/
+
+int sim_rdctl(int reg)
+{
+	switch (reg) {
+	case 0: return sim_status;
+	case 3: return sim_ienable;
+	case 4: return sim_ipending() & sim_ienable;
+	}
+	return 0;
+}
+
+void sim_wrctl(int reg, int data)
+{
+	if (reg == 0) sim_status = data;
+	if (reg == 3) sim_ienable = data;
+	sim_dispatch();
+}
+
+/*------------------------------------------------/
+ Name:				HAL interrupt API
+ Description: replaces alt_iic_isr_register.c
+ ------------------------------------------------*/
+
+int alt_ic_isr_register(alt_u32 ic_id, alt_u32 irq, alt_isr_func isr,
+		void* isr_context, void* flags)
+{
+	if (irq >= 32) return -1;
+
+	sim_irq[irq].isr = isr;
+	sim_irq[irq].context = isr_context;
+	if (isr) sim_ienable |= 1u << irq;
+	else     sim_ienable &= ~(1u << irq);
+	sim_dispatch();
+	return 0;
+}
+
+int alt_ic_irq_enable(alt_u32 ic_id, alt_u32 irq)
+{
+	if (sim_irq[irq].isr) sim_ienable |= 1u << irq;
+	sim_dispatch();
+	return 0;
+}
+
+int alt_ic_irq_disable(alt_u32 ic_id, alt_u32 irq)
+{
+	sim_ienable &= ~(1u << irq);
+	return 0;
+}
+
+alt_u32 alt_ic_irq_enabled(alt_u32 ic_id, alt_u32 irq)
+{
+	return (sim_ienable >> irq) & 1;
+}
+
+/*------------------------------------------------/
+ Name:				sim_boot
+ Description: runs before main(), in place of
+ 	 	 	  alt_main(): alt_irq_init() and the
+ 	 	 	  timer part of alt_sys_init()
+ ------------------------------------------------*/
+
+__attribute__((constructor))
+static void sim_boot(void)
+{
+	const char* env;
+
+	if ((env = getenv("SIM_CYCLES"))) sim_end = strtoull(env, NULL, 0);
+	switch_script_parse(getenv("SIM_SW"));
+	if ((env = getenv("SIM_TRACE"))) plant.trace = fopen(env, "w");
+	plant.sample_at = 50000;
+	memset(lcd.ddram, ' ', sizeof(lcd.ddram));
+
+	sim_status = NIOS2_STATUS_PIE_MSK;
+	alt_avalon_timer_sc_init((void*)TIMER_0_BASE, TIMER_0_IRQ_INTERRUPT_CONTROLLER_ID,
+			TIMER_0_IRQ, TIMER_0_TICKS_PER_SEC);
+	altera_avalon_timer_ts_base = (void*)TIMER_1_BASE;
+	altera_avalon_timer_ts_freq = TIMER_1_FREQ;
+}
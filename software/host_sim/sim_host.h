@@ -0,0 +1,59 @@
+#ifndef SIM_HOST_H_
+#define SIM_HOST_H_
+
+/*###################################################
+ 	 	 	 	 HOST SIMULATOR
+- Force-included (gcc -include sim_host.h) in front of
+  every application and BSP source built for Linux
+- Replaces the Nios II I/O and control-register
+  builtins used by io.h and nios2.h with calls into
+  the register-level model in sim.c
+- Pins the HAL integer types to their Nios II widths
+  so modular timestamp arithmetic matches the board
+###################################################*/
+
+#include <stdint.h>
+
+/* Take the place of HAL/inc/alt_types.h: alt_u32 must stay 32-bit on LP64 */
+#define __ALT_TYPES_H__
+
+typedef int8_t   alt_8;
+typedef uint8_t  alt_u8;
+typedef int16_t  alt_16;
+typedef uint16_t alt_u16;
+typedef int32_t  alt_32;
+typedef uint32_t alt_u32;
+typedef int64_t  alt_64;
+typedef uint64_t alt_u64;
+
+#define ALT_INLINE        __inline__
+#define ALT_ALWAYS_INLINE __attribute__ ((always_inline))
+#define ALT_WEAK          __attribute__((weak))
+
+/* Bus cost in 50MHz clock cycles charged by the model */
+#define SIM_IORD_CYCLES		6
+#define SIM_IOWR_CYCLES		4
+#define SIM_IRQ_CYCLES		120				// exception entry + alt_irq_handler + return
+
+/* Virtual 50MHz clock: cycles since reset, the report is printed at sim_end */
+extern alt_u64 sim_cycles;
+extern alt_u64 sim_end;
+
+alt_u32 sim_iord(alt_u32 addr);
+void    sim_iowr(alt_u32 addr, alt_u32 data);
+int     sim_rdctl(int reg);
+void    sim_wrctl(int reg, int data);
+void    sim_advance(alt_u32 cycles);
+void    sim_pwm_sample(alt_u64* high, alt_u64* period);
+void    sim_reversal_sample(alt_u32 ch, alt_u64* reversals, alt_u64* min_gap);
+
+#define __builtin_ldwio(a)		sim_iord((alt_u32)(uintptr_t)(a))
+#define __builtin_ldhuio(a)		(sim_iord((alt_u32)(uintptr_t)(a)) & 0xFFFF)
+#define __builtin_ldbuio(a)		(sim_iord((alt_u32)(uintptr_t)(a)) & 0xFF)
+#define __builtin_stwio(a, d)	sim_iowr((alt_u32)(uintptr_t)(a), (d))
+#define __builtin_sthio(a, d)	sim_iowr((alt_u32)(uintptr_t)(a), (d) & 0xFFFF)
+#define __builtin_stbio(a, d)	sim_iowr((alt_u32)(uintptr_t)(a), (d) & 0xFF)
+#define __builtin_rdctl(r)		sim_rdctl(r)
+#define __builtin_wrctl(r, d)	sim_wrctl((r), (d))
+
+#endif /* SIM_HOST_H_ */